@@ -0,0 +1,56 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Minimal timing helpers for the ssg benchmarks
+ */
+
+/**
+ * @file bench.hpp
+ * @brief Minimal timing helpers for the ssg benchmarks
+ *
+ * Runs a function repeatedly and reports the best of several rounds, which
+ * is stable enough to compare two implementations on the same machine.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <string_view>
+
+namespace bench {
+
+/// Keeps the compiler from optimizing away a benchmarked result
+template <class T> inline void keep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Best time of a number of rounds, each calling f iterations times.
+ * @return Seconds per call.
+ */
+template <class F> double bestTime(F &&f, size_t iterations, int rounds = 5) {
+  double best = 1e30;
+  for (int round = 0; round < rounds; ++round) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      f();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / static_cast<double>(iterations));
+  }
+  return best;
+}
+
+/// Prints one result line: name, time per call and throughput
+inline void report(std::string_view name, double seconds, size_t bytes) {
+  const double mbPerSecond = static_cast<double>(bytes) / seconds / (1024.0 * 1024.0);
+  std::cout << std::format("{:<50} {:>10.3f} us {:>10.1f} MiB/s\n", name, seconds * 1e6, mbPerSecond);
+}
+
+} // namespace bench
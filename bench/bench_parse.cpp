@@ -0,0 +1,95 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Benchmark of parsing a 1 MiB inja template
+ */
+
+/**
+ * @file bench_parse.cpp
+ * @brief Benchmark of parsing a 1 MiB inja template
+ *
+ * Parses a 1 MiB template made of page-like HTML text with sparse and with
+ * dense template tags. The scan for opening delimiters is also timed on its
+ * own, against std::string_view::find_first_of as used by the original
+ * lexer, with the default delimiters ("#{") and with the four different
+ * first characters of custom ones.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Libraries
+#include <inja.hpp>
+
+#include "bench.hpp"
+
+namespace {
+
+constexpr size_t templateSize = 1024 * 1024;
+
+/// Builds a template of about templateSize bytes, with a tag after every `textLength` bytes of HTML
+std::string makeTemplate(size_t textLength) {
+  static const std::string html = "<p class=\"content\">Lorem ipsum dolor sit amet, consectetur adipiscing elit, "
+                                  "sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.</p>\n";
+  static const std::vector<std::string> tags = {
+      "{{ page.title }}", "{% if page.draft %}draft{% endif %}", "{# note #}",
+      "{% for item in nav %}<li>{{ item.title }}</li>{% endfor %}", "{{ upper(site.name) }}",
+  };
+  std::string result;
+  result.reserve(templateSize + html.size());
+  for (size_t i = 0; result.size() < templateSize; ++i) {
+    for (size_t written = 0; written < textLength; written += html.size()) {
+      result.append(html, 0, std::min(html.size(), textLength - written));
+    }
+    result += tags[i % tags.size()];
+  }
+  return result;
+}
+
+/// Counts the opening delimiter candidates of in with a scan function
+template <class Find> size_t countCandidates(std::string_view in, Find &&find) {
+  size_t count = 0;
+  for (size_t pos = 0;;) {
+    const size_t found = find(in.substr(pos));
+    if (found == std::string_view::npos) {
+      return count;
+    }
+    ++count;
+    pos += found + 1;
+  }
+}
+
+} // namespace
+
+int main() {
+  int status = 0;
+  for (const size_t textLength : {8192, 1024, 64}) {
+    const std::string input = makeTemplate(textLength);
+    const std::string name = std::format("1 MiB, a tag every {} B", textLength);
+
+    inja::Environment env;
+    const double parse = bench::bestTime([&] { bench::keep(env.parse(input)); }, 10);
+    bench::report(name + " parse", parse, input.size());
+
+    for (const std::string_view openChars : {std::string_view("#{"), std::string_view("#{<$")}) {
+      const auto original = [&](std::string_view in) { return in.find_first_of(openChars); };
+      const auto current = [&](std::string_view in) { return inja::detail::find_open_char(in, openChars); };
+      if (countCandidates(input, original) != countCandidates(input, current)) {
+        std::cerr << "Mismatch for " << name << "\n";
+        status = 1;
+        continue;
+      }
+
+      const double reference = bench::bestTime([&] { bench::keep(countCandidates(input, original)); }, 20);
+      const double scan = bench::bestTime([&] { bench::keep(countCandidates(input, current)); }, 20);
+      bench::report(std::format("{} scan \"{}\" original", name, openChars), reference, input.size());
+      bench::report(std::format("{} scan \"{}\" current", name, openChars), scan, input.size());
+    }
+  }
+  return status;
+}
@@ -88,9 +88,12 @@ std::abort();                 \
 #ifndef INCLUDE_INJA_TEMPLATE_HPP_
 #define INCLUDE_INJA_TEMPLATE_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 // #include "node.hpp"
 #ifndef INCLUDE_INJA_NODE_HPP_
@@ -263,6 +266,18 @@ public:
 #include <string_view>
 #include <utility>
 
+#ifndef INJA_SIMD
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define INJA_SIMD 1
+#else
+#define INJA_SIMD 0
+#endif
+#endif
+
+#if INJA_SIMD
+#include <immintrin.h>
+#endif
+
 // #include "exceptions.hpp"
 #ifndef INCLUDE_INJA_EXCEPTIONS_HPP_
 #define INCLUDE_INJA_EXCEPTIONS_HPP_
@@ -370,6 +385,92 @@ inline void replace_substring(std::string& s, const std::string& f, const std::s
   {}
 }
 
+namespace detail {
+
+/// A small set of bytes to search for, e.g. the characters that need HTML escaping
+template <size_t N> struct ByteSet {
+  char bytes[N];
+};
+
+// The comparisons with the bytes of the set are expanded at compile time
+template <size_t N, size_t... I>
+inline const char* find_first_of_bytes_scalar(const char* first, const char* last, const ByteSet<N>& set, std::index_sequence<I...>) {
+  for (; first != last; ++first) {
+    const char c = *first;
+    if (((c == set.bytes[I]) || ...)) {
+      return first;
+    }
+  }
+  return last;
+}
+
+template <size_t N> inline const char* find_first_of_bytes_scalar(const char* first, const char* last, const ByteSet<N>& set) {
+  return find_first_of_bytes_scalar(first, last, set, std::make_index_sequence<N> {});
+}
+
+#if INJA_SIMD
+template <size_t N, size_t... I>
+inline const char* find_first_of_bytes_sse2(const char* first, const char* last, const ByteSet<N>& set, std::index_sequence<I...>) {
+  const __m128i needles[N] {_mm_set1_epi8(set.bytes[I])...};
+  for (; last - first >= 16; first += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    const __m128i hits = (_mm_cmpeq_epi8(chunk, needles[I]) | ...);
+    const int mask = _mm_movemask_epi8(hits);
+    if (mask != 0) {
+      return first + __builtin_ctz(static_cast<unsigned int>(mask));
+    }
+  }
+  return find_first_of_bytes_scalar(first, last, set);
+}
+
+template <size_t N> inline const char* find_first_of_bytes_sse2(const char* first, const char* last, const ByteSet<N>& set) {
+  return find_first_of_bytes_sse2(first, last, set, std::make_index_sequence<N> {});
+}
+
+template <size_t N, size_t... I>
+__attribute__((target("avx2"))) inline const char* find_first_of_bytes_avx2(const char* first, const char* last, const ByteSet<N>& set,
+                                                                              std::index_sequence<I...>) {
+  const __m256i needles[N] {_mm256_set1_epi8(set.bytes[I])...};
+  for (; last - first >= 32; first += 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    const __m256i hits = (_mm256_cmpeq_epi8(chunk, needles[I]) | ...);
+    const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+    if (mask != 0) {
+      return first + __builtin_ctz(mask);
+    }
+  }
+  return find_first_of_bytes_sse2(first, last, set);
+}
+
+template <size_t N>
+__attribute__((target("avx2"))) inline const char* find_first_of_bytes_avx2(const char* first, const char* last, const ByteSet<N>& set) {
+  return find_first_of_bytes_avx2(first, last, set, std::make_index_sequence<N> {});
+}
+
+/// Whether the CPU supports AVX2, detected once
+inline bool cpu_has_avx2() {
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return supported;
+}
+#endif
+
+/// Returns the first byte in [first, last) that is in set, or last. Uses the widest vector width the CPU supports
+template <size_t N> inline const char* find_first_of_bytes(const char* first, const char* last, const ByteSet<N>& set) {
+#if INJA_SIMD
+  if (cpu_has_avx2()) {
+    return find_first_of_bytes_avx2(first, last, set);
+  }
+  return find_first_of_bytes_sse2(first, last, set);
+#else
+  return find_first_of_bytes_scalar(first, last, set);
+#endif
+}
+
+} // namespace detail
+
 } // namespace inja
 
 #endif // INCLUDE_INJA_UTILS_HPP_
@@ -379,6 +480,8 @@ inline void replace_substring(std::string& s, const std::string& f, const std::s
 
 namespace inja {
 
+struct Template;
+
 class NodeVisitor;
 class BlockNode;
 class TextNode;
@@ -468,6 +571,7 @@ public:
   const json value;
 
   explicit LiteralNode(std::string_view data_text, size_t pos): ExpressionNode(pos), value(json::parse(data_text)) {}
+  explicit LiteralNode(json value, size_t pos): ExpressionNode(pos), value(std::move(value)) {}
 
   void accept(NodeVisitor& v) const override {
     v.visit(*this);
@@ -478,6 +582,8 @@ class DataNode : public ExpressionNode {
 public:
   const std::string name;
   const json::json_pointer ptr;
+  const std::string root;           // First segment of the name, e.g. "page" for "page.title"
+  const json::json_pointer sub_ptr; // Remaining path below root, empty if the name has a single segment
 
   static std::string convert_dot_to_ptr(std::string_view ptr_name) {
     std::string result;
@@ -490,7 +596,14 @@ public:
     return result;
   }
 
-  explicit DataNode(std::string_view ptr_name, size_t pos): ExpressionNode(pos), name(ptr_name), ptr(json::json_pointer(convert_dot_to_ptr(ptr_name))) {}
+  static std::string convert_sub_ptr(std::string_view ptr_name) {
+    const auto rest = string_view::split(ptr_name, '.').second;
+    return rest.empty() ? std::string() : convert_dot_to_ptr(rest);
+  }
+
+  explicit DataNode(std::string_view ptr_name, size_t pos)
+      : ExpressionNode(pos), name(ptr_name), ptr(json::json_pointer(convert_dot_to_ptr(ptr_name))), root(string_view::split(ptr_name, '.').first),
+        sub_ptr(json::json_pointer(convert_sub_ptr(ptr_name))) {}
 
   void accept(NodeVisitor& v) const override {
     v.visit(*this);
@@ -641,6 +754,7 @@ public:
   ExpressionListNode condition;
   BlockNode body;
   BlockNode* const parent;
+  bool body_has_set {false}; // A set statement in the body may change the iterated value
 
   explicit ForStatementNode(BlockNode* const parent, size_t pos): StatementNode(pos), parent(parent) {}
 
@@ -692,6 +806,8 @@ public:
 class IncludeStatementNode : public StatementNode {
 public:
   const std::string file;
+  const Template* resolved {nullptr}; ///< Included template, valid for the storage with id resolved_in
+  uint64_t resolved_in {0};
 
   explicit IncludeStatementNode(const std::string& file, size_t pos): StatementNode(pos), file(file) {}
 
@@ -703,6 +819,8 @@ public:
 class ExtendsStatementNode : public StatementNode {
 public:
   const std::string file;
+  const Template* resolved {nullptr}; ///< Parent template, valid for the storage with id resolved_in
+  uint64_t resolved_in {0};
 
   explicit ExtendsStatementNode(const std::string& file, size_t pos): StatementNode(pos), file(file) {}
 
@@ -744,6 +862,10 @@ public:
 #ifndef INCLUDE_INJA_STATISTICS_HPP_
 #define INCLUDE_INJA_STATISTICS_HPP_
 
+#include <set>
+#include <string>
+#include <vector>
+
 // #include "node.hpp"
 
 
@@ -812,6 +934,157 @@ public:
   explicit StatisticsVisitor() {}
 };
 
+/*!
+ * \brief A class for collecting the names of all variables and callbacks used by a Template.
+ *
+ * Variables are collected by their first segment, so `page.title` is reported as `page`. Loop and set
+ * variables are included as well, the result is a superset of the data the template needs.
+ */
+class VariableCollector : public NodeVisitor {
+  void visit(const BlockNode& node) override {
+    for (const auto& n : node.nodes) {
+      n->accept(*this);
+    }
+  }
+
+  void visit(const TextNode&) override {}
+  void visit(const ExpressionNode&) override {}
+  void visit(const LiteralNode&) override {}
+
+  void visit(const DataNode& node) override {
+    variables.insert(node.root);
+  }
+
+  void visit(const FunctionNode& node) override {
+    if (node.operation == FunctionStorage::Operation::Callback) {
+      functions.insert(node.name);
+    } else if (node.operation == FunctionStorage::Operation::Exists) {
+      collect_exists(node);
+    }
+    for (const auto& n : node.arguments) {
+      n->accept(*this);
+    }
+  }
+
+  /// exists("name") looks the variable up by a string, which may only be known at render time
+  void collect_exists(const FunctionNode& node) {
+    const auto literal = node.arguments.empty() ? nullptr : std::dynamic_pointer_cast<LiteralNode>(node.arguments[0]);
+    if (literal != nullptr && literal->value.is_string()) {
+      const auto& name = literal->value.get_ref<const json::string_t&>();
+      variables.insert(name.substr(0, name.find_first_of("./")));
+    } else {
+      uses_any_variable = true;
+    }
+  }
+
+  void visit(const ExpressionListNode& node) override {
+    if (node.root) {
+      node.root->accept(*this);
+    }
+  }
+
+  void visit(const StatementNode&) override {}
+  void visit(const ForStatementNode&) override {}
+
+  void visit(const ForArrayStatementNode& node) override {
+    node.condition.accept(*this);
+    node.body.accept(*this);
+  }
+
+  void visit(const ForObjectStatementNode& node) override {
+    node.condition.accept(*this);
+    node.body.accept(*this);
+  }
+
+  void visit(const IfStatementNode& node) override {
+    node.condition.accept(*this);
+    node.true_statement.accept(*this);
+    node.false_statement.accept(*this);
+  }
+
+  void visit(const IncludeStatementNode&) override {}
+
+  void visit(const ExtendsStatementNode&) override {}
+
+  void visit(const BlockStatementNode& node) override {
+    node.block.accept(*this);
+  }
+
+  void visit(const SetStatementNode& node) override {
+    node.expression.accept(*this);
+  }
+
+public:
+  std::set<std::string, std::less<>> variables;
+  std::set<std::string, std::less<>> functions;
+  bool uses_any_variable {false}; // A variable name is computed at render time
+
+  explicit VariableCollector() {}
+};
+
+/*!
+ * \brief A class for collecting the names of all templates a Template includes or extends.
+ *
+ * Names are kept in the order they are found, each once. Visiting the collected templates in turn gives
+ * the templates reachable through other includes as well.
+ */
+class IncludeCollector : public NodeVisitor {
+  std::set<std::string, std::less<>> known;
+
+  void add(const std::string& name) {
+    if (known.insert(name).second) {
+      templates.push_back(name);
+    }
+  }
+
+  void visit(const BlockNode& node) override {
+    for (const auto& n : node.nodes) {
+      n->accept(*this);
+    }
+  }
+
+  void visit(const TextNode&) override {}
+  void visit(const ExpressionNode&) override {}
+  void visit(const LiteralNode&) override {}
+  void visit(const DataNode&) override {}
+  void visit(const FunctionNode&) override {}
+  void visit(const ExpressionListNode&) override {}
+  void visit(const StatementNode&) override {}
+  void visit(const ForStatementNode&) override {}
+
+  void visit(const ForArrayStatementNode& node) override {
+    node.body.accept(*this);
+  }
+
+  void visit(const ForObjectStatementNode& node) override {
+    node.body.accept(*this);
+  }
+
+  void visit(const IfStatementNode& node) override {
+    node.true_statement.accept(*this);
+    node.false_statement.accept(*this);
+  }
+
+  void visit(const IncludeStatementNode& node) override {
+    add(node.file);
+  }
+
+  void visit(const ExtendsStatementNode& node) override {
+    add(node.file);
+  }
+
+  void visit(const BlockStatementNode& node) override {
+    node.block.accept(*this);
+  }
+
+  void visit(const SetStatementNode&) override {}
+
+public:
+  std::vector<std::string> templates;
+
+  explicit IncludeCollector() {}
+};
+
 } // namespace inja
 
 #endif // INCLUDE_INJA_STATISTICS_HPP_
@@ -838,7 +1111,50 @@ struct Template {
   }
 };
 
-using TemplateStorage = std::map<std::string, Template>;
+/*!
+ * \brief Hashed storage of all named templates.
+ *
+ * Include and extends nodes keep a pointer to their template together with the id of the storage it was
+ * resolved in. Every storage object gets a new id, also when copied, so the pointer is only used with the
+ * storage it points into. Templates are never erased, so the pointers stay valid.
+ */
+class TemplateStorage : public std::unordered_map<std::string, Template> {
+  uint64_t id {next_id()};
+
+  static uint64_t next_id() {
+    static std::atomic<uint64_t> counter {0};
+    return ++counter;
+  }
+
+public:
+  TemplateStorage() = default;
+  TemplateStorage(const TemplateStorage& other): std::unordered_map<std::string, Template>(other) {}
+  TemplateStorage(TemplateStorage&& other) noexcept: std::unordered_map<std::string, Template>(std::move(other)) {}
+
+  TemplateStorage& operator=(const TemplateStorage& other) {
+    std::unordered_map<std::string, Template>::operator=(other);
+    id = next_id();
+    return *this;
+  }
+
+  TemplateStorage& operator=(TemplateStorage&& other) noexcept {
+    std::unordered_map<std::string, Template>::operator=(std::move(other));
+    id = next_id();
+    return *this;
+  }
+
+  uint64_t get_id() const {
+    return id;
+  }
+
+  /// Resolves the template of an include or extends node in this storage
+  template <class Node>
+  void resolve(Node& node) const {
+    const auto it = find(node.file);
+    node.resolved = (it != end()) ? &it->second : nullptr;
+    node.resolved_in = id;
+  }
+};
 
 } // namespace inja
 
@@ -904,6 +1220,7 @@ struct LexerConfig {
  */
 struct ParserConfig {
   bool search_included_templates_in_files {true};
+  bool fold_constants {true};
 
   std::function<Template(const std::filesystem::path&, const std::string&)> include_callback;
 };
@@ -949,6 +1266,7 @@ struct RenderConfig {
 
 #include <cctype>
 #include <cstddef>
+#include <cstring>
 #include <string_view>
 
 // #include "config.hpp"
@@ -1036,6 +1354,29 @@ struct Token {
 
 namespace inja {
 
+namespace detail {
+
+/// Returns the offset of the first character of in that is one of open_chars, or npos
+inline size_t find_open_char(std::string_view in, std::string_view open_chars) {
+  if (open_chars.size() == 1) {
+    const void* found = std::memchr(in.data(), open_chars[0], in.size());
+    return (found != nullptr) ? static_cast<size_t>(static_cast<const char*>(found) - in.data()) : std::string_view::npos;
+  }
+  if (open_chars.empty() || open_chars.size() > 4) {
+    return in.find_first_of(open_chars);
+  }
+
+  // Up to four characters that can start an opening delimiter, padded by repeating the first one
+  ByteSet<4> open;
+  for (size_t i = 0; i < 4; ++i) {
+    open.bytes[i] = open_chars[i < open_chars.size() ? i : 0];
+  }
+  const char* found = find_first_of_bytes(in.data(), in.data() + in.size(), open);
+  return (found != in.data() + in.size()) ? static_cast<size_t>(found - in.data()) : std::string_view::npos;
+}
+
+} // namespace detail
+
 /*!
  * \brief Class for lexing an inja Template.
  */
@@ -1330,7 +1671,7 @@ public:
     default:
     case State::Text: {
       // fast-scan to first open character
-      const size_t open_start = m_in.substr(pos).find_first_of(config.open_chars);
+      const size_t open_start = detail::find_open_char(m_in.substr(pos), config.open_chars);
       if (open_start == std::string_view::npos) {
         // didn't find open, return remaining text as text token
         pos = m_in.size();
@@ -2002,14 +2343,20 @@ class Parser {
       get_next_token();
 
       current_block = for_statement_data->parent;
+      const bool body_has_set = for_statement_data->body_has_set;
       for_statement_stack.pop();
+      if (body_has_set && !for_statement_stack.empty()) {
+        for_statement_stack.top()->body_has_set = true;
+      }
     } else if (tok.text == static_cast<decltype(tok.text)>("include")) {
       get_next_token();
 
       std::string template_name = parse_filename();
       add_to_template_storage(path, template_name);
 
-      current_block->nodes.emplace_back(std::make_shared<IncludeStatementNode>(template_name, tok.text.data() - tmpl.content.c_str()));
+      auto include_statement_node = std::make_shared<IncludeStatementNode>(template_name, tok.text.data() - tmpl.content.c_str());
+      template_storage.resolve(*include_statement_node);
+      current_block->nodes.emplace_back(include_statement_node);
 
       get_next_token();
     } else if (tok.text == static_cast<decltype(tok.text)>("extends")) {
@@ -2018,7 +2365,9 @@ class Parser {
       std::string template_name = parse_filename();
       add_to_template_storage(path, template_name);
 
-      current_block->nodes.emplace_back(std::make_shared<ExtendsStatementNode>(template_name, tok.text.data() - tmpl.content.c_str()));
+      auto extends_statement_node = std::make_shared<ExtendsStatementNode>(template_name, tok.text.data() - tmpl.content.c_str());
+      template_storage.resolve(*extends_statement_node);
+      current_block->nodes.emplace_back(extends_statement_node);
 
       get_next_token();
     } else if (tok.text == static_cast<decltype(tok.text)>("set")) {
@@ -2033,6 +2382,9 @@ class Parser {
 
       auto set_statement_node = std::make_shared<SetStatementNode>(key, tok.text.data() - tmpl.content.c_str());
       current_block->nodes.emplace_back(set_statement_node);
+      if (!for_statement_stack.empty()) {
+        for_statement_stack.top()->body_has_set = true;
+      }
       current_expression_list = &set_statement_node->expression;
 
       if (tok.text != static_cast<decltype(tok.text)>("=")) {
@@ -2150,6 +2502,7 @@ public:
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <charconv>
 #include <cmath>
 #include <cstddef>
 #include <memory>
@@ -2158,6 +2511,7 @@ public:
 #include <sstream>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -2169,93 +2523,327 @@ public:
 
 // #include "node.hpp"
 
-// #include "template.hpp"
+// #include "output_sink.hpp"
+#ifndef INCLUDE_INJA_OUTPUT_SINK_HPP_
+#define INCLUDE_INJA_OUTPUT_SINK_HPP_
 
-// #include "throw.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
 
-// #include "utils.hpp"
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define INJA_HAS_FILE_DESCRIPTOR_SINK 1
+#endif
+
+// #include "exceptions.hpp"
+
+// #include "throw.hpp"
 
 
 namespace inja {
 
 /*!
-@brief Escapes HTML
-*/
-inline std::string htmlescape(const std::string& data) {
-  std::string buffer;
-  buffer.reserve(static_cast<size_t>(1.1 * data.size()));
-  for (size_t pos = 0; pos != data.size(); ++pos) {
-    switch (data[pos]) {
-      case '&':  buffer.append("&amp;");       break;
-      case '\"': buffer.append("&quot;");      break;
-      case '\'': buffer.append("&apos;");      break;
-      case '<':  buffer.append("&lt;");        break;
-      case '>':  buffer.append("&gt;");        break;
-      default:   buffer.append(&data[pos], 1); break;
-    }
+ * \brief Destination of rendered output. The renderer writes text and printed values directly into a sink.
+ */
+class OutputSink {
+  virtual void write(const char* data, size_t size) = 0;
+
+public:
+  virtual ~OutputSink() = default;
+
+  void append(const char* data, size_t size) {
+    write(data, size);
   }
-  return buffer;
-}
+
+  void append(std::string_view data) {
+    write(data.data(), data.size());
+  }
+};
 
 /*!
- * \brief Class for rendering a Template with data.
+ * \brief Appends the output to a std::string, which can be reused across renders.
  */
-class Renderer : public NodeVisitor {
-  using Op = FunctionStorage::Operation;
+class StringSink : public OutputSink {
+  std::string& buffer;
 
-  const RenderConfig config;
-  const TemplateStorage& template_storage;
-  const FunctionStorage& function_storage;
+  void write(const char* data, size_t size) override {
+    buffer.append(data, size);
+  }
 
-  const Template* current_template;
-  size_t current_level {0};
-  std::vector<const Template*> template_stack;
-  std::vector<const BlockStatementNode*> block_statement_stack;
+public:
+  explicit StringSink(std::string& buffer): buffer(buffer) {}
+};
 
-  const json* data_input;
-  std::ostream* output_stream;
+/*!
+ * \brief Writes the output to a std::ostream.
+ */
+class StreamSink : public OutputSink {
+  std::ostream& os;
 
-  json additional_data;
-  json* current_loop_data = &additional_data["loop"];
+  void write(const char* data, size_t size) override {
+    os.write(data, static_cast<std::streamsize>(size));
+  }
 
-  std::vector<std::shared_ptr<json>> data_tmp_stack;
-  std::stack<const json*> data_eval_stack;
-  std::stack<const DataNode*> not_found_stack;
+public:
+  explicit StreamSink(std::ostream& os): os(os) {}
+};
 
-  bool break_rendering {false};
+/*!
+ * \brief Writes the output into a fixed, caller-owned buffer. Output beyond the capacity is dropped.
+ */
+class FixedBufferSink : public OutputSink {
+  char* buffer;
+  size_t capacity;
+  size_t length {0};
+  bool overflow {false};
+
+  void write(const char* data, size_t size) override {
+    const size_t count = std::min(size, capacity - length);
+    std::memcpy(buffer + length, data, count);
+    length += count;
+    overflow = overflow || (count != size);
+  }
 
-  static bool truthy(const json* data) {
-    if (data->is_boolean()) {
-      return data->get<bool>();
-    } else if (data->is_number()) {
-      return (*data != 0);
-    } else if (data->is_null()) {
-      return false;
-    }
-    return !data->empty();
+public:
+  explicit FixedBufferSink(char* buffer, size_t capacity): buffer(buffer), capacity(capacity) {}
+
+  size_t size() const {
+    return length;
   }
 
-  void print_data(const std::shared_ptr<json>& value) {
-    if (value->is_string()) {
-      if (config.html_autoescape) {
-        *output_stream << htmlescape(value->get_ref<const json::string_t&>());
-      } else {
-        *output_stream << value->get_ref<const json::string_t&>();
-      }
-    } else if (value->is_number_unsigned()) {
-      *output_stream << value->get<const json::number_unsigned_t>();
-    } else if (value->is_number_integer()) {
-      *output_stream << value->get<const json::number_integer_t>();
-    } else if (value->is_null()) {
-    } else {
-      *output_stream << value->dump();
-    }
+  bool overflowed() const {
+    return overflow;
   }
 
-  const std::shared_ptr<json> eval_expression_list(const ExpressionListNode& expression_list) {
-    if (!expression_list.root) {
-      throw_renderer_error("empty expression", expression_list);
-    }
+  std::string_view view() const {
+    return std::string_view(buffer, length);
+  }
+};
+
+/*!
+ * \brief Computes a 64-bit FNV-1a hash of the output without storing it, e.g. to detect unchanged pages.
+ */
+class HashSink : public OutputSink {
+  uint64_t state {14695981039346656037ULL};
+  size_t length {0};
+
+  void write(const char* data, size_t size) override {
+    for (size_t i = 0; i < size; ++i) {
+      state ^= static_cast<unsigned char>(data[i]);
+      state *= 1099511628211ULL;
+    }
+    length += size;
+  }
+
+public:
+  uint64_t hash() const {
+    return state;
+  }
+
+  size_t size() const {
+    return length;
+  }
+};
+
+#ifdef INJA_HAS_FILE_DESCRIPTOR_SINK
+/*!
+ * \brief Writes the output to a file descriptor, batching small writes into a buffer of the given size.
+ */
+class FileDescriptorSink : public OutputSink {
+  int fd;
+  std::string buffer;
+  size_t batch_size;
+
+  void write_all(const char* data, size_t size) {
+    while (size > 0) {
+      const ssize_t written = ::write(fd, data, size);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        INJA_THROW(FileError("failed writing to file descriptor: " + std::string(std::strerror(errno))));
+      }
+      data += written;
+      size -= static_cast<size_t>(written);
+    }
+  }
+
+  void write(const char* data, size_t size) override {
+    if (buffer.size() + size > batch_size) {
+      flush();
+      if (size >= batch_size) {
+        write_all(data, size);
+        return;
+      }
+    }
+    buffer.append(data, size);
+  }
+
+public:
+  explicit FileDescriptorSink(int fd, size_t batch_size = 64 * 1024): fd(fd), batch_size(batch_size) {
+    buffer.reserve(batch_size);
+  }
+
+  FileDescriptorSink(const FileDescriptorSink&) = delete;
+  FileDescriptorSink& operator=(const FileDescriptorSink&) = delete;
+
+  ~FileDescriptorSink() override {
+    try {
+      flush();
+    } catch (...) {
+    }
+  }
+
+  void flush() {
+    write_all(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+};
+#endif
+
+} // namespace inja
+
+#endif // INCLUDE_INJA_OUTPUT_SINK_HPP_
+
+// #include "template.hpp"
+
+// #include "throw.hpp"
+
+// #include "utils.hpp"
+
+
+namespace inja {
+
+namespace detail {
+
+/// The characters that need HTML escaping
+inline constexpr ByteSet<5> html_special_bytes {{'&', '\"', '\'', '<', '>'}};
+
+/// Returns the first character in [first, last) that needs HTML escaping, or last
+inline const char* find_html_special(const char* first, const char* last) {
+  return find_first_of_bytes(first, last, html_special_bytes);
+}
+
+} // namespace detail
+
+/*!
+@brief Appends the HTML escaped data to buffer (a std::string or OutputSink), copying clean runs in bulk
+*/
+template <class Buffer> inline void htmlescape_to(Buffer& buffer, std::string_view data) {
+  const char* first = data.data();
+  const char* const last = first + data.size();
+  while (first != last) {
+    const char* special = detail::find_html_special(first, last);
+    buffer.append(first, static_cast<size_t>(special - first));
+    if (special == last) {
+      break;
+    }
+
+    switch (*special) {
+      case '&':  buffer.append("&amp;", 5);  break;
+      case '\"': buffer.append("&quot;", 6); break;
+      case '\'': buffer.append("&apos;", 6); break;
+      case '<':  buffer.append("&lt;", 4);   break;
+      case '>':  buffer.append("&gt;", 4);   break;
+    }
+    first = special + 1;
+  }
+}
+
+/*!
+@brief Escapes HTML
+*/
+inline std::string htmlescape(const std::string& data) {
+  std::string buffer;
+  buffer.reserve(data.size() + data.size() / 4);
+  htmlescape_to(buffer, data);
+  return buffer;
+}
+
+/*!
+ * \brief Class for rendering a Template with data.
+ */
+class Renderer : public NodeVisitor {
+  using Op = FunctionStorage::Operation;
+
+  /// State of a running for loop. The loop variable references the element in place, and the
+  /// loop metadata is kept as plain integers that are only converted to json on access.
+  struct LoopFrame {
+    const json* container;
+    const json* value;
+    json key;                      // Only used by object loops
+    size_t index;
+    size_t size;
+  };
+
+  /// Value of a loop variable name. As with a single slot per name, the innermost loop binds the name to its
+  /// element, the end of the loop leaves the cleared element behind, and a set moves it to additional_data.
+  struct LoopBinding {
+    const std::string* name;
+    size_t level;
+    bool is_key;
+    bool ended;                    // The loop is over, value holds the cleared element
+    json value;
+  };
+
+  const RenderConfig config;
+  const TemplateStorage& template_storage;
+  const FunctionStorage& function_storage;
+
+  const Template* current_template;
+  size_t current_level {0};
+  std::vector<const Template*> template_stack;
+  std::vector<const BlockStatementNode*> block_statement_stack;
+
+  const json* data_input;
+  const json* globals {nullptr};
+  OutputSink* output;
+
+  json additional_data;
+  std::vector<LoopFrame> loop_stack;
+  std::vector<LoopBinding> loop_bindings;
+  const Renderer* including_renderer {nullptr}; // Renderer of the including template, its loops stay visible
+  size_t outer_loop_depth {0};
+
+  std::vector<std::shared_ptr<json>> data_tmp_stack;
+  std::stack<const json*, std::vector<const json*>> data_eval_stack;
+  std::stack<const DataNode*, std::vector<const DataNode*>> not_found_stack;
+
+  bool break_rendering {false};
+
+  template <class T> void print_number(T value) {
+    std::array<char, 24> buffer;
+    const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+    output->append(buffer.data(), static_cast<size_t>(result.ptr - buffer.data()));
+  }
+
+  void print_data(const json* value) {
+    if (value->is_string()) {
+      if (config.html_autoescape) {
+        htmlescape_to(*output, value->get_ref<const json::string_t&>());
+      } else {
+        output->append(value->get_ref<const json::string_t&>());
+      }
+    } else if (value->is_number_unsigned()) {
+      print_number(value->get<const json::number_unsigned_t>());
+    } else if (value->is_number_integer()) {
+      print_number(value->get<const json::number_integer_t>());
+    } else if (value->is_null()) {
+    } else {
+      output->append(value->dump());
+    }
+  }
+
+  const json* eval_expression_list_ref(const ExpressionListNode& expression_list) {
+    if (!expression_list.root) {
+      throw_renderer_error("empty expression", expression_list);
+    }
 
     expression_list.root->accept(*this);
 
@@ -2278,7 +2866,103 @@ class Renderer : public NodeVisitor {
 
       throw_renderer_error("variable '" + static_cast<std::string>(node->name) + "' not found", *node);
     }
-    return std::make_shared<json>(*result);
+    return result;
+  }
+
+  const std::shared_ptr<json> eval_expression_list(const ExpressionListNode& expression_list) {
+    return std::make_shared<json>(*eval_expression_list_ref(expression_list));
+  }
+
+  size_t loop_depth() const {
+    return outer_loop_depth + loop_stack.size();
+  }
+
+  const LoopFrame& loop_frame(size_t level) const {
+    if (level < outer_loop_depth) {
+      return including_renderer->loop_frame(level);
+    }
+    return loop_stack[level - outer_loop_depth];
+  }
+
+  json materialize_loop_data(size_t level) const {
+    const LoopFrame& frame = loop_frame(level);
+    json result;
+    result["index"] = frame.index;
+    result["index1"] = frame.index + 1;
+    result["is_first"] = (frame.index == 0);
+    result["is_last"] = (frame.index + 1 == frame.size);
+    if (level > 0) {
+      result["parent"] = materialize_loop_data(level - 1);
+    }
+    return result;
+  }
+
+  bool find_loop_data(const DataNode& node) {
+    if (loop_depth() == 0 || node.root != "loop") {
+      return false;
+    }
+
+    const LoopFrame& frame = loop_frame(loop_depth() - 1);
+    if (node.name == "loop.index") {
+      make_result(frame.index);
+    } else if (node.name == "loop.index1") {
+      make_result(frame.index + 1);
+    } else if (node.name == "loop.is_first") {
+      make_result(frame.index == 0);
+    } else if (node.name == "loop.is_last") {
+      make_result(frame.index + 1 == frame.size);
+    } else {
+      auto result_ptr = std::make_shared<json>(materialize_loop_data(loop_depth() - 1));
+      if (!result_ptr->contains(node.sub_ptr)) {
+        return false;
+      }
+      data_tmp_stack.push_back(result_ptr);
+      data_eval_stack.push(&(*result_ptr)[node.sub_ptr]);
+    }
+    return true;
+  }
+
+  const LoopBinding* find_loop_binding(std::string_view name) const {
+    for (const auto& binding : loop_bindings) {
+      if (*binding.name == name) {
+        return &binding;
+      }
+    }
+    return nullptr;
+  }
+
+  const json& loop_binding_value(const LoopBinding& binding) const {
+    if (binding.ended) {
+      return binding.value;
+    }
+    const LoopFrame& frame = loop_frame(binding.level);
+    return binding.is_key ? frame.key : *frame.value;
+  }
+
+  void bind_loop_variable(LoopBinding&& binding) {
+    for (auto& existing : loop_bindings) {
+      if (*existing.name == *binding.name) {
+        existing = std::move(binding);
+        return;
+      }
+    }
+    loop_bindings.push_back(std::move(binding));
+  }
+
+  void unbind_loop_variable(std::string_view name) {
+    loop_bindings.erase(std::remove_if(loop_bindings.begin(), loop_bindings.end(), [name](const LoopBinding& binding) { return *binding.name == name; }),
+                        loop_bindings.end());
+  }
+
+  /// Keeps the last value of the variable cleared, without writing additional_data that outer loops may iterate
+  void end_loop_variable(const std::string& name) {
+    json::value_t type = json::value_t::null;
+    if (const LoopBinding* binding = find_loop_binding(name)) {
+      type = loop_binding_value(*binding).type();
+    } else if (const auto it = additional_data.find(name); it != additional_data.end()) {
+      type = it->type();
+    }
+    bind_loop_variable(LoopBinding {&name, 0, false, true, json(type)});
   }
 
   void throw_renderer_error(const std::string& message, const AstNode& node) {
@@ -2360,7 +3044,7 @@ class Renderer : public NodeVisitor {
   }
 
   void visit(const TextNode& node) override {
-    output_stream->write(current_template->content.c_str() + node.pos, node.length);
+    output->append(current_template->content.c_str() + node.pos, node.length);
   }
 
   void visit(const ExpressionNode&) override {}
@@ -2370,10 +3054,22 @@ class Renderer : public NodeVisitor {
   }
 
   void visit(const DataNode& node) override {
-    if (additional_data.contains(node.ptr)) {
+    if (find_loop_data(node)) {
+      return;
+    }
+
+    const LoopBinding* binding = find_loop_binding(node.root);
+    const json* loop_variable = (binding != nullptr) ? &loop_binding_value(*binding) : nullptr;
+    if (loop_variable != nullptr && node.sub_ptr.empty()) {
+      data_eval_stack.push(loop_variable);
+    } else if (loop_variable != nullptr && loop_variable->contains(node.sub_ptr)) {
+      data_eval_stack.push(&(*loop_variable)[node.sub_ptr]);
+    } else if (binding == nullptr && additional_data.contains(node.ptr)) {
       data_eval_stack.push(&(additional_data[node.ptr]));
     } else if (data_input->contains(node.ptr)) {
       data_eval_stack.push(&(*data_input)[node.ptr]);
+    } else if (globals != nullptr && globals->contains(node.ptr)) {
+      data_eval_stack.push(&(*globals)[node.ptr]);
     } else {
       // Try to evaluate as a no-argument callback
       const auto function_data = function_storage.find_function(node.name, 0);
@@ -2670,89 +3366,68 @@ class Renderer : public NodeVisitor {
   }
 
   void visit(const ExpressionListNode& node) override {
-    print_data(eval_expression_list(node));
+    print_data(eval_expression_list_ref(node));
   }
 
   void visit(const StatementNode&) override {}
 
   void visit(const ForStatementNode&) override {}
 
+  /// A set in the loop body may replace or grow the iterated value (or one of its parents), so iterate a copy
+  const json* copy_loop_container(const json* container) {
+    auto copy = std::make_shared<json>(*container);
+    data_tmp_stack.push_back(copy);
+    return copy.get();
+  }
+
   void visit(const ForArrayStatementNode& node) override {
-    const auto result = eval_expression_list(node.condition);
+    const json* result = eval_expression_list_ref(node.condition);
     if (!result->is_array()) {
       throw_renderer_error("object must be an array", node);
     }
-
-    if (!current_loop_data->empty()) {
-      auto tmp = *current_loop_data; // Because of clang-3
-      (*current_loop_data)["parent"] = std::move(tmp);
+    if (node.body_has_set) {
+      result = copy_loop_container(result);
     }
 
-    size_t index = 0;
-    (*current_loop_data)["is_first"] = true;
-    (*current_loop_data)["is_last"] = (result->size() <= 1);
-    for (auto it = result->begin(); it != result->end(); ++it) {
-      additional_data[static_cast<std::string>(node.value)] = *it;
-
-      (*current_loop_data)["index"] = index;
-      (*current_loop_data)["index1"] = index + 1;
-      if (index == 1) {
-        (*current_loop_data)["is_first"] = false;
-      }
-      if (index == result->size() - 1) {
-        (*current_loop_data)["is_last"] = true;
-      }
+    loop_stack.push_back(LoopFrame {result, nullptr, json(), 0, result->size()});
+    for (size_t index = 0; index < loop_stack.back().size; ++index) {
+      // Re-fetch the frame, nested loops may have reallocated the stack
+      LoopFrame& frame = loop_stack.back();
+      frame.index = index;
+      frame.value = &(*frame.container)[index];
+      bind_loop_variable(LoopBinding {&node.value, loop_depth() - 1, false, false, json()});
 
       node.body.accept(*this);
-      ++index;
-    }
-
-    additional_data[static_cast<std::string>(node.value)].clear();
-    if (!(*current_loop_data)["parent"].empty()) {
-      const auto tmp = (*current_loop_data)["parent"];
-      *current_loop_data = tmp;
-    } else {
-      current_loop_data = &additional_data["loop"];
     }
+    end_loop_variable(node.value);
+    loop_stack.pop_back();
   }
 
   void visit(const ForObjectStatementNode& node) override {
-    const auto result = eval_expression_list(node.condition);
+    const json* result = eval_expression_list_ref(node.condition);
     if (!result->is_object()) {
       throw_renderer_error("object must be an object", node);
     }
-
-    if (!current_loop_data->empty()) {
-      (*current_loop_data)["parent"] = std::move(*current_loop_data);
+    if (node.body_has_set) {
+      result = copy_loop_container(result);
     }
 
+    loop_stack.push_back(LoopFrame {result, nullptr, json(), 0, result->size()});
     size_t index = 0;
-    (*current_loop_data)["is_first"] = true;
-    (*current_loop_data)["is_last"] = (result->size() <= 1);
     for (auto it = result->begin(); it != result->end(); ++it) {
-      additional_data[static_cast<std::string>(node.key)] = it.key();
-      additional_data[static_cast<std::string>(node.value)] = it.value();
-
-      (*current_loop_data)["index"] = index;
-      (*current_loop_data)["index1"] = index + 1;
-      if (index == 1) {
-        (*current_loop_data)["is_first"] = false;
-      }
-      if (index == result->size() - 1) {
-        (*current_loop_data)["is_last"] = true;
-      }
+      LoopFrame& frame = loop_stack.back();
+      frame.index = index;
+      frame.key = it.key();
+      frame.value = &it.value();
+      bind_loop_variable(LoopBinding {&node.key, loop_depth() - 1, true, false, json()});
+      bind_loop_variable(LoopBinding {&node.value, loop_depth() - 1, false, false, json()});
 
       node.body.accept(*this);
       ++index;
     }
-
-    additional_data[static_cast<std::string>(node.key)].clear();
-    additional_data[static_cast<std::string>(node.value)].clear();
-    if (!(*current_loop_data)["parent"].empty()) {
-      *current_loop_data = std::move((*current_loop_data)["parent"]);
-    } else {
-      current_loop_data = &additional_data["loop"];
-    }
+    end_loop_variable(node.key);
+    end_loop_variable(node.value);
+    loop_stack.pop_back();
   }
 
   void visit(const IfStatementNode& node) override {
@@ -2764,21 +3439,34 @@ class Renderer : public NodeVisitor {
     }
   }
 
+  /// Uses the template resolved at parse time, looks it up by name only if it belongs to another storage
+  template <class Node>
+  const Template* find_template(const Node& node) const {
+    if (node.resolved != nullptr && node.resolved_in == template_storage.get_id()) {
+      return node.resolved;
+    }
+    const auto it = template_storage.find(node.file);
+    return (it != template_storage.end()) ? &it->second : nullptr;
+  }
+
   void visit(const IncludeStatementNode& node) override {
-    auto sub_renderer = Renderer(config, template_storage, function_storage);
-    const auto included_template_it = template_storage.find(node.file);
-    if (included_template_it != template_storage.end()) {
-      sub_renderer.render_to(*output_stream, included_template_it->second, *data_input, &additional_data);
+    const Template* included_template = find_template(node);
+    if (included_template != nullptr) {
+      auto sub_renderer = Renderer(config, template_storage, function_storage);
+      sub_renderer.globals = globals;
+      sub_renderer.including_renderer = this;
+      sub_renderer.outer_loop_depth = loop_depth();
+      sub_renderer.loop_bindings = loop_bindings;
+      sub_renderer.render_to(*output, *included_template, *data_input, &additional_data);
     } else if (config.throw_at_missing_includes) {
       throw_renderer_error("include '" + node.file + "' not found", node);
     }
   }
 
   void visit(const ExtendsStatementNode& node) override {
-    const auto included_template_it = template_storage.find(node.file);
-    if (included_template_it != template_storage.end()) {
-      const Template* parent_template = &included_template_it->second;
-      render_to(*output_stream, *parent_template, *data_input, &additional_data);
+    const Template* parent_template = find_template(node);
+    if (parent_template != nullptr) {
+      render_to(*output, *parent_template, *data_input, &additional_data);
       break_rendering = true;
     } else if (config.throw_at_missing_includes) {
       throw_renderer_error("extends '" + node.file + "' not found", node);
@@ -2803,20 +3491,79 @@ class Renderer : public NodeVisitor {
     std::string ptr = node.key;
     replace_substring(ptr, ".", "/");
     ptr = "/" + ptr;
-    additional_data[json::json_pointer(ptr)] = *eval_expression_list(node.expression);
+    const json::json_pointer json_ptr(ptr);
+    const auto value = eval_expression_list(node.expression);
+    const std::string_view root = string_view::split(node.key, '.').first;
+    if (const LoopBinding* binding = find_loop_binding(root)) {
+      // The set changes a copy of the element, not the iterated value
+      additional_data[static_cast<std::string>(root)] = loop_binding_value(*binding);
+      unbind_loop_variable(root);
+    }
+    additional_data[json_ptr] = *value;
   }
 
 public:
+  static bool truthy(const json* data) {
+    if (data->is_boolean()) {
+      return data->get<bool>();
+    } else if (data->is_number()) {
+      return (*data != 0);
+    } else if (data->is_null()) {
+      return false;
+    }
+    return !data->empty();
+  }
+
   explicit Renderer(const RenderConfig& config, const TemplateStorage& template_storage, const FunctionStorage& function_storage)
       : config(config), template_storage(template_storage), function_storage(function_storage) {}
 
+  /// Clears all state of a previous render, but keeps the allocated capacity for the next one
+  void reset() {
+    current_level = 0;
+    template_stack.clear();
+    block_statement_stack.clear();
+    additional_data.clear();
+    loop_stack.clear();
+    loop_bindings.clear();
+    including_renderer = nullptr;
+    outer_loop_depth = 0;
+    data_tmp_stack.clear();
+    while (!data_eval_stack.empty()) {
+      data_eval_stack.pop();
+    }
+    while (!not_found_stack.empty()) {
+      not_found_stack.pop();
+    }
+    break_rendering = false;
+  }
+
   void render_to(std::ostream& os, const Template& tmpl, const json& data, json* loop_data = nullptr) {
-    output_stream = &os;
+    StreamSink sink(os);
+    render_to(sink, tmpl, data, loop_data);
+  }
+
+  /// Sets data shared by all renders, looked up after the render data. It is not copied and must outlive the renders
+  void set_globals(const json* globals) {
+    this->globals = globals;
+  }
+
+  /// Evaluates an expression of tmpl without any data, e.g. to fold constant expressions after parsing
+  json eval_constant(const Template& tmpl, const ExpressionListNode& expression_list) {
+    static const json no_data;
+    reset();
+    current_template = &tmpl;
+    data_input = &no_data;
+    json result = *eval_expression_list_ref(expression_list);
+    data_tmp_stack.clear();
+    return result;
+  }
+
+  void render_to(OutputSink& sink, const Template& tmpl, const json& data, json* loop_data = nullptr) {
+    output = &sink;
     current_template = &tmpl;
     data_input = &data;
     if (loop_data != nullptr) {
       additional_data = *loop_data;
-      current_loop_data = &additional_data["loop"];
     }
 
     template_stack.emplace_back(current_template);
@@ -2830,45 +3577,860 @@ public:
 
 #endif // INCLUDE_INJA_RENDERER_HPP_
 
-// #include "template.hpp"
+// #include "constant_folder.hpp"
+#ifndef INCLUDE_INJA_CONSTANT_FOLDER_HPP_
+#define INCLUDE_INJA_CONSTANT_FOLDER_HPP_
 
-// #include "throw.hpp"
+#include <memory>
+#include <utility>
+#include <vector>
+
+// #include "config.hpp"
+
+// #include "function_storage.hpp"
+
+// #include "node.hpp"
+
+// #include "renderer.hpp"
+
+// #include "template.hpp"
 
 
 namespace inja {
 
 /*!
- * \brief Class for changing the configuration.
+ * \brief Folds constant subexpressions of a freshly parsed Template and prunes if statements with a constant condition.
+ *
+ * Operations whose arguments are all literals are evaluated once, so rendering only evaluates data dependent
+ * nodes. Callbacks and functions that read the data are never folded, and an expression that fails to
+ * evaluate is kept as is, so that it still raises its error at render time.
  */
-class Environment {
-  FunctionStorage function_storage;
-  TemplateStorage template_storage;
-
-protected:
-  LexerConfig lexer_config;
-  ParserConfig parser_config;
-  RenderConfig render_config;
-
-  std::filesystem::path input_path;
-  std::filesystem::path output_path;
+class ConstantFolder {
+  using Op = FunctionStorage::Operation;
 
-public:
-  Environment(): Environment("") {}
-  explicit Environment(const std::filesystem::path& global_path): input_path(global_path), output_path(global_path) {}
-  Environment(const std::filesystem::path& input_path, const std::filesystem::path& output_path): input_path(input_path), output_path(output_path) {}
+  const Template& tmpl;
+  Renderer renderer;
 
-  /// Sets the opener and closer for template statements
-  void set_statement(const std::string& open, const std::string& close) {
-    lexer_config.statement_open = open;
-    lexer_config.statement_open_no_lstrip = open + "+";
-    lexer_config.statement_open_force_lstrip = open + "-";
-    lexer_config.statement_close = close;
-    lexer_config.statement_close_force_rstrip = "-" + close;
-    lexer_config.update_open_chars();
+  static bool is_foldable(Op operation) {
+    switch (operation) {
+    case Op::Exists:
+    case Op::ExistsInObject:
+    case Op::Super:
+    case Op::Callback:
+    case Op::None:
+      return false;
+    default:
+      return true;
+    }
   }
 
-  /// Sets the opener for template line statements
-  void set_line_statement(const std::string& open) {
+  std::shared_ptr<ExpressionNode> fold(const std::shared_ptr<ExpressionNode>& node) {
+    const auto function = std::dynamic_pointer_cast<FunctionNode>(node);
+    if (!function) {
+      return node;
+    }
+
+    bool constant = is_foldable(function->operation);
+    for (auto& argument : function->arguments) {
+      argument = fold(argument);
+      constant = constant && std::dynamic_pointer_cast<LiteralNode>(argument) != nullptr;
+    }
+    if (!constant) {
+      return node;
+    }
+
+#if !defined(INJA_NOEXCEPTION)
+    try {
+      ExpressionListNode expression_list(function->pos);
+      expression_list.root = function;
+      return std::make_shared<LiteralNode>(renderer.eval_constant(tmpl, expression_list), function->pos);
+    } catch (const std::exception&) {
+      return node;
+    }
+#else
+    return node;
+#endif
+  }
+
+  void fold(ExpressionListNode& expression_list) {
+    if (expression_list.root) {
+      expression_list.root = fold(expression_list.root);
+    }
+  }
+
+  void fold(BlockNode& block) {
+    std::vector<std::shared_ptr<AstNode>> nodes;
+    nodes.reserve(block.nodes.size());
+    for (auto& node : block.nodes) {
+      if (const auto expression_list = std::dynamic_pointer_cast<ExpressionListNode>(node)) {
+        fold(*expression_list);
+      } else if (const auto if_statement = std::dynamic_pointer_cast<IfStatementNode>(node)) {
+        fold(if_statement->condition);
+        fold(if_statement->true_statement);
+        fold(if_statement->false_statement);
+
+        // A constant condition is replaced by the branch it takes
+        if (const auto literal = std::dynamic_pointer_cast<LiteralNode>(if_statement->condition.root)) {
+          const BlockNode& taken = Renderer::truthy(&literal->value) ? if_statement->true_statement : if_statement->false_statement;
+          nodes.insert(nodes.end(), taken.nodes.begin(), taken.nodes.end());
+          continue;
+        }
+      } else if (const auto for_statement = std::dynamic_pointer_cast<ForStatementNode>(node)) {
+        fold(for_statement->condition);
+        fold(for_statement->body);
+      } else if (const auto block_statement = std::dynamic_pointer_cast<BlockStatementNode>(node)) {
+        fold(block_statement->block);
+      } else if (const auto set_statement = std::dynamic_pointer_cast<SetStatementNode>(node)) {
+        fold(set_statement->expression);
+      }
+      nodes.push_back(node);
+    }
+    block.nodes = std::move(nodes);
+  }
+
+public:
+  explicit ConstantFolder(const Template& tmpl, const RenderConfig& config, const TemplateStorage& template_storage,
+                          const FunctionStorage& function_storage)
+      : tmpl(tmpl), renderer(config, template_storage, function_storage) {}
+
+  /// Folds the template in place, its nodes must not be shared with templates that are rendered concurrently
+  static void fold(Template& tmpl, const RenderConfig& config, const TemplateStorage& template_storage, const FunctionStorage& function_storage) {
+    ConstantFolder folder(tmpl, config, template_storage, function_storage);
+    folder.fold(tmpl.root);
+  }
+};
+
+} // namespace inja
+
+#endif // INCLUDE_INJA_CONSTANT_FOLDER_HPP_
+
+// #include "template_cache.hpp"
+#ifndef INCLUDE_INJA_TEMPLATE_CACHE_HPP_
+#define INCLUDE_INJA_TEMPLATE_CACHE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INJA_HAS_MMAP 1
+#endif
+
+// #include "config.hpp"
+
+// #include "function_storage.hpp"
+
+// #include "node.hpp"
+
+// #include "output_sink.hpp"
+
+// #include "template.hpp"
+
+
+namespace inja {
+
+/*!
+ * \brief Read-only view of a whole file, memory mapped where the platform supports it.
+ */
+class MappedFile {
+  const char* data {nullptr};
+  size_t size {0};
+#ifdef INJA_HAS_MMAP
+  void* mapping {nullptr};
+#else
+  std::string content;
+#endif
+
+public:
+  explicit MappedFile(const std::filesystem::path& path) {
+#ifdef INJA_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+      void* result = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (result != MAP_FAILED) {
+        mapping = result;
+        data = static_cast<const char*>(result);
+        size = static_cast<size_t>(info.st_size);
+      }
+    }
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (file) {
+      content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      data = content.data();
+      size = content.size();
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+#ifdef INJA_HAS_MMAP
+    if (mapping != nullptr) {
+      ::munmap(mapping, size);
+    }
+#endif
+  }
+
+  std::string_view view() const {
+    return std::string_view(data, size);
+  }
+};
+
+/*!
+ * \brief On-disk cache of parsed templates.
+ *
+ * A cache file stores the AST of a template and of all templates it includes from files. It is keyed by a
+ * hash of the template content, its path and the lexer config, and is only used while the content hashes
+ * of all included files still match.
+ */
+class TemplateCache {
+  static constexpr uint32_t magic {0x434A4E49}; // "INJC"
+  static constexpr uint32_t format_version {3};
+  static constexpr size_t header_size {24};
+
+  enum class Tag : uint8_t {
+    Null,
+    Text,
+    Literal,
+    Data,
+    Function,
+    ExpressionList,
+    ForArray,
+    ForObject,
+    If,
+    Include,
+    Extends,
+    Block,
+    Set,
+  };
+
+  class Writer : public NodeVisitor {
+    std::string& out;
+
+    void write_tag(Tag tag, const AstNode& node) {
+      write<uint8_t>(static_cast<uint8_t>(tag));
+      write<uint64_t>(node.pos);
+    }
+
+    void visit(const BlockNode& node) override {
+      write<uint64_t>(node.nodes.size());
+      for (const auto& n : node.nodes) {
+        n->accept(*this);
+      }
+    }
+
+    void visit(const TextNode& node) override {
+      write_tag(Tag::Text, node);
+      write<uint64_t>(node.length);
+    }
+
+    void visit(const ExpressionNode&) override {}
+
+    void visit(const LiteralNode& node) override {
+      write_tag(Tag::Literal, node);
+      write_string(node.value.dump());
+    }
+
+    void visit(const DataNode& node) override {
+      write_tag(Tag::Data, node);
+      write_string(node.name);
+    }
+
+    void visit(const FunctionNode& node) override {
+      write_tag(Tag::Function, node);
+      write<int32_t>(static_cast<int32_t>(node.operation));
+      write_string(node.name);
+      write<int32_t>(node.number_args);
+      write<uint64_t>(node.arguments.size());
+      for (const auto& n : node.arguments) {
+        n->accept(*this);
+      }
+    }
+
+    void visit(const ExpressionListNode& node) override {
+      write_tag(Tag::ExpressionList, node);
+      if (node.root) {
+        node.root->accept(*this);
+      } else {
+        write<uint8_t>(static_cast<uint8_t>(Tag::Null));
+        write<uint64_t>(0);
+      }
+    }
+
+    void visit(const StatementNode&) override {}
+    void visit(const ForStatementNode&) override {}
+
+    void visit(const ForArrayStatementNode& node) override {
+      write_tag(Tag::ForArray, node);
+      write_string(node.value);
+      write<uint8_t>(node.body_has_set ? 1 : 0);
+      node.condition.accept(*this);
+      node.body.accept(*this);
+    }
+
+    void visit(const ForObjectStatementNode& node) override {
+      write_tag(Tag::ForObject, node);
+      write_string(node.key);
+      write_string(node.value);
+      write<uint8_t>(node.body_has_set ? 1 : 0);
+      node.condition.accept(*this);
+      node.body.accept(*this);
+    }
+
+    void visit(const IfStatementNode& node) override {
+      write_tag(Tag::If, node);
+      write<uint8_t>(node.is_nested);
+      write<uint8_t>(node.has_false_statement);
+      node.condition.accept(*this);
+      node.true_statement.accept(*this);
+      node.false_statement.accept(*this);
+    }
+
+    void visit(const IncludeStatementNode& node) override {
+      write_tag(Tag::Include, node);
+      write_string(node.file);
+    }
+
+    void visit(const ExtendsStatementNode& node) override {
+      write_tag(Tag::Extends, node);
+      write_string(node.file);
+    }
+
+    void visit(const BlockStatementNode& node) override {
+      write_tag(Tag::Block, node);
+      write_string(node.name);
+      node.block.accept(*this);
+    }
+
+    void visit(const SetStatementNode& node) override {
+      write_tag(Tag::Set, node);
+      write_string(node.key);
+      node.expression.accept(*this);
+    }
+
+  public:
+    explicit Writer(std::string& out): out(out) {}
+
+    template <class T> void write(T value) {
+      out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write_string(std::string_view text) {
+      write<uint64_t>(text.size());
+      out.append(text.data(), text.size());
+    }
+  };
+
+  class Reader {
+    std::string_view data;
+    size_t offset {0};
+    const FunctionStorage& function_storage;
+
+    std::shared_ptr<ExpressionNode> read_expression() {
+      const auto tag = static_cast<Tag>(read<uint8_t>());
+      const auto pos = static_cast<size_t>(read<uint64_t>());
+      switch (tag) {
+      case Tag::Null:
+        return nullptr;
+      case Tag::Literal: {
+        const auto text = read_string();
+        if (failed || !json::accept(text)) {
+          break;
+        }
+        return std::make_shared<LiteralNode>(text, pos);
+      }
+      case Tag::Data:
+        return std::make_shared<DataNode>(read_string(), pos);
+      case Tag::Function: {
+        const auto op = read<int32_t>();
+        const auto name = read_string();
+        const auto number_args = read<int32_t>();
+        if (failed || op < 0 || op > static_cast<int32_t>(FunctionStorage::Operation::None)) {
+          break;
+        }
+
+        const auto operation = static_cast<FunctionStorage::Operation>(op);
+        auto node = name.empty() ? std::make_shared<FunctionNode>(operation, pos) : std::make_shared<FunctionNode>(name, pos);
+        node->operation = operation;
+        node->number_args = number_args;
+        if (operation == FunctionStorage::Operation::Callback) {
+          // Callbacks can't be stored, resolve them again from the current environment
+          const auto function_data = function_storage.find_function(name, number_args);
+          if (function_data.operation != FunctionStorage::Operation::Callback) {
+            break;
+          }
+          node->callback = function_data.callback;
+        }
+
+        const size_t count = read_count();
+        for (size_t i = 0; i < count && !failed; ++i) {
+          node->arguments.emplace_back(read_expression());
+        }
+        return node;
+      }
+      default:
+        break;
+      }
+      failed = true;
+      return nullptr;
+    }
+
+    void read_expression_list(ExpressionListNode& node) {
+      if (static_cast<Tag>(read<uint8_t>()) != Tag::ExpressionList) {
+        failed = true;
+        return;
+      }
+      node.pos = static_cast<size_t>(read<uint64_t>());
+      node.root = read_expression();
+    }
+
+    std::shared_ptr<AstNode> read_node(BlockNode* parent, Template& tmpl) {
+      const auto tag = static_cast<Tag>(read<uint8_t>());
+      const auto pos = static_cast<size_t>(read<uint64_t>());
+      switch (tag) {
+      case Tag::Text:
+        return std::make_shared<TextNode>(pos, static_cast<size_t>(read<uint64_t>()));
+      case Tag::ExpressionList: {
+        auto node = std::make_shared<ExpressionListNode>(pos);
+        node->root = read_expression();
+        return node;
+      }
+      case Tag::ForArray: {
+        auto node = std::make_shared<ForArrayStatementNode>(std::string(read_string()), parent, pos);
+        node->body_has_set = read<uint8_t>() != 0;
+        read_expression_list(node->condition);
+        read_block(node->body, tmpl);
+        return node;
+      }
+      case Tag::ForObject: {
+        const auto key = std::string(read_string());
+        auto node = std::make_shared<ForObjectStatementNode>(key, std::string(read_string()), parent, pos);
+        node->body_has_set = read<uint8_t>() != 0;
+        read_expression_list(node->condition);
+        read_block(node->body, tmpl);
+        return node;
+      }
+      case Tag::If: {
+        const bool is_nested = read<uint8_t>() != 0;
+        auto node = std::make_shared<IfStatementNode>(is_nested, parent, pos);
+        node->has_false_statement = read<uint8_t>() != 0;
+        read_expression_list(node->condition);
+        read_block(node->true_statement, tmpl);
+        read_block(node->false_statement, tmpl);
+        return node;
+      }
+      case Tag::Include: {
+        auto node = std::make_shared<IncludeStatementNode>(std::string(read_string()), pos);
+        include_nodes.push_back(node);
+        return node;
+      }
+      case Tag::Extends: {
+        auto node = std::make_shared<ExtendsStatementNode>(std::string(read_string()), pos);
+        extends_nodes.push_back(node);
+        return node;
+      }
+      case Tag::Block: {
+        const auto name = std::string(read_string());
+        auto node = std::make_shared<BlockStatementNode>(parent, name, pos);
+        read_block(node->block, tmpl);
+        tmpl.block_storage.emplace(name, node);
+        return node;
+      }
+      case Tag::Set: {
+        auto node = std::make_shared<SetStatementNode>(std::string(read_string()), pos);
+        read_expression_list(node->expression);
+        return node;
+      }
+      default:
+        failed = true;
+        return nullptr;
+      }
+    }
+
+  public:
+    bool failed {false};
+    std::vector<std::shared_ptr<IncludeStatementNode>> include_nodes; ///< Read nodes, resolved once all templates are stored
+    std::vector<std::shared_ptr<ExtendsStatementNode>> extends_nodes;
+
+    explicit Reader(std::string_view data, const FunctionStorage& function_storage): data(data), function_storage(function_storage) {}
+
+    template <class T> T read() {
+      T value {};
+      if (failed || data.size() - offset < sizeof(T)) {
+        failed = true;
+        return value;
+      }
+      std::memcpy(&value, data.data() + offset, sizeof(T));
+      offset += sizeof(T);
+      return value;
+    }
+
+    std::string_view read_string() {
+      const auto size = read<uint64_t>();
+      if (failed || data.size() - offset < size) {
+        failed = true;
+        return {};
+      }
+      const auto result = data.substr(offset, static_cast<size_t>(size));
+      offset += static_cast<size_t>(size);
+      return result;
+    }
+
+    size_t read_count() {
+      const auto count = read<uint64_t>();
+      if (count > data.size() - offset) { // Every entry takes at least one byte
+        failed = true;
+        return 0;
+      }
+      return static_cast<size_t>(count);
+    }
+
+    void read_block(BlockNode& block, Template& tmpl) {
+      const size_t count = read_count();
+      for (size_t i = 0; i < count && !failed; ++i) {
+        auto node = read_node(&block, tmpl);
+        if (node) {
+          block.nodes.emplace_back(node);
+        }
+      }
+    }
+  };
+
+  std::filesystem::path directory;
+
+  static uint64_t hash(std::string_view text) {
+    HashSink sink;
+    sink.append(text);
+    return sink.hash();
+  }
+
+  static uint64_t config_hash(const LexerConfig& lexer_config, const ParserConfig& parser_config) {
+    HashSink sink;
+    for (const auto* text : {&lexer_config.statement_open, &lexer_config.statement_open_no_lstrip, &lexer_config.statement_open_force_lstrip,
+                             &lexer_config.statement_close, &lexer_config.statement_close_force_rstrip, &lexer_config.line_statement,
+                             &lexer_config.expression_open, &lexer_config.expression_open_force_lstrip, &lexer_config.expression_close,
+                             &lexer_config.expression_close_force_rstrip, &lexer_config.comment_open, &lexer_config.comment_open_force_lstrip,
+                             &lexer_config.comment_close, &lexer_config.comment_close_force_rstrip}) {
+      sink.append(*text);
+      sink.append("\n", 1);
+    }
+    const char flags[] = {static_cast<char>(lexer_config.trim_blocks), static_cast<char>(lexer_config.lstrip_blocks),
+                          static_cast<char>(parser_config.search_included_templates_in_files), static_cast<char>(parser_config.fold_constants)};
+    sink.append(flags, sizeof(flags));
+    return sink.hash();
+  }
+
+  std::filesystem::path cache_file(const std::filesystem::path& filename, std::string_view content, uint64_t config) const {
+    HashSink sink;
+    const uint64_t header[] = {format_version, config, hash(content), content.size()};
+    sink.append(reinterpret_cast<const char*>(header), sizeof(header));
+    sink.append(filename.string());
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.injac", static_cast<unsigned long long>(sink.hash()));
+    return directory / name;
+  }
+
+  static bool read_file(const std::string& filename, std::string& content) {
+    std::ifstream file(filename, std::ios::binary);
+    if (file.fail()) {
+      return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+  }
+
+public:
+  explicit TemplateCache(const std::filesystem::path& directory): directory(directory) {}
+
+  /// Loads the AST of tmpl (whose content is already set) and its included templates from the cache
+  bool load(const std::filesystem::path& filename, Template& tmpl, const LexerConfig& lexer_config, const ParserConfig& parser_config,
+            TemplateStorage& template_storage, const FunctionStorage& function_storage) const {
+    const uint64_t config = config_hash(lexer_config, parser_config);
+    const MappedFile file(cache_file(filename, tmpl.content, config));
+    Reader reader(file.view(), function_storage);
+    if (reader.read<uint32_t>() != magic || reader.read<uint32_t>() != format_version || reader.read<uint64_t>() != config) {
+      return false;
+    }
+    const auto payload_hash = reader.read<uint64_t>();
+    if (reader.failed || hash(file.view().substr(header_size)) != payload_hash) {
+      return false;
+    }
+
+    // Included files that changed on disk invalidate the entry
+    const size_t dependency_count = reader.read_count();
+    std::string content;
+    for (size_t i = 0; i < dependency_count && !reader.failed; ++i) {
+      const auto name = std::string(reader.read_string());
+      const auto content_hash = reader.read<uint64_t>();
+      if (reader.failed || !read_file(name, content) || hash(content) != content_hash) {
+        return false;
+      }
+    }
+
+    std::vector<std::pair<std::string, Template>> included;
+    const size_t template_count = reader.read_count();
+    for (size_t i = 0; i < template_count && !reader.failed; ++i) {
+      auto name = std::string(reader.read_string());
+      included.emplace_back(std::move(name), Template(std::string(reader.read_string())));
+      reader.read_block(included.back().second.root, included.back().second);
+    }
+
+    Template result(tmpl.content);
+    reader.read_block(result.root, result);
+    if (reader.failed) {
+      return false;
+    }
+
+    for (auto& entry : included) {
+      template_storage.emplace(std::move(entry.first), std::move(entry.second));
+    }
+    for (const auto& node : reader.include_nodes) {
+      template_storage.resolve(*node);
+    }
+    for (const auto& node : reader.extends_nodes) {
+      template_storage.resolve(*node);
+    }
+    tmpl = std::move(result);
+    return true;
+  }
+
+  /// Stores a freshly parsed template. Only templates in included_names are stored alongside, and all of them must be files
+  void store(const std::filesystem::path& filename, const Template& tmpl, const LexerConfig& lexer_config, const ParserConfig& parser_config,
+             const TemplateStorage& template_storage, const std::vector<std::string>& included_names) const {
+    const uint64_t config = config_hash(lexer_config, parser_config);
+
+    std::string payload;
+    Writer writer(payload);
+    writer.write<uint64_t>(included_names.size());
+    std::string content;
+    for (const auto& name : included_names) {
+      const auto it = template_storage.find(name);
+      if (it == template_storage.end() || !read_file(name, content) || content != it->second.content) {
+        return; // e.g. provided by an include callback, which can't be validated later on
+      }
+      writer.write_string(name);
+      writer.write<uint64_t>(hash(content));
+    }
+
+    writer.write<uint64_t>(included_names.size());
+    for (const auto& name : included_names) {
+      const Template& included = template_storage.at(name);
+      writer.write_string(name);
+      writer.write_string(included.content);
+      included.root.accept(writer);
+    }
+    tmpl.root.accept(writer);
+
+    std::string out;
+    Writer header(out);
+    header.write<uint32_t>(magic);
+    header.write<uint32_t>(format_version);
+    header.write<uint64_t>(config);
+    header.write<uint64_t>(hash(payload));
+    out += payload;
+
+    // Write to a temporary file first, so concurrent readers never see a partial entry
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    const auto path = cache_file(filename, tmpl.content, config);
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+    {
+      std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+      if (!file.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+        return;
+      }
+    }
+    std::filesystem::rename(temporary_path, path, ec);
+  }
+};
+
+} // namespace inja
+
+#endif // INCLUDE_INJA_TEMPLATE_CACHE_HPP_
+
+// #include "template.hpp"
+
+// #include "throw.hpp"
+
+
+namespace inja {
+
+/*!
+ * \brief An immutable, parsed template together with a snapshot of everything needed to render it.
+ *
+ * All members are read-only after construction, so one handle can be shared across threads. Each
+ * thread renders through its own RenderContext.
+ */
+class CompiledTemplate {
+  std::shared_ptr<const Template> tmpl;
+  std::shared_ptr<const TemplateStorage> template_storage;
+  std::shared_ptr<const FunctionStorage> function_storage;
+  std::shared_ptr<const VariableCollector> names;
+  RenderConfig render_config;
+
+  /// Collects the names used by the template and everything it may include or extend
+  static std::shared_ptr<const VariableCollector> collect_names(const Template& tmpl, const TemplateStorage& template_storage) {
+    auto collector = std::make_shared<VariableCollector>();
+    tmpl.root.accept(*collector);
+    for (const auto& stored : template_storage) {
+      stored.second.root.accept(*collector);
+    }
+    return collector;
+  }
+
+public:
+  /// The template storage is shared, it must not be modified afterwards (Environment copies it on write)
+  explicit CompiledTemplate(Template tmpl, std::shared_ptr<const TemplateStorage> template_storage, FunctionStorage function_storage,
+                            const RenderConfig& render_config)
+      : tmpl(std::make_shared<const Template>(std::move(tmpl))), template_storage(std::move(template_storage)),
+        function_storage(std::make_shared<const FunctionStorage>(std::move(function_storage))),
+        names(collect_names(*this->tmpl, *this->template_storage)), render_config(render_config) {}
+
+  /// Returns whether the template (or a template it includes) may read the top-level variable `name`
+  bool uses_variable(std::string_view name) const {
+    return names->uses_any_variable || names->variables.find(name) != names->variables.end();
+  }
+
+  /// Returns whether the template (or a template it includes) calls the callback `name`
+  bool uses_function(std::string_view name) const {
+    return names->functions.find(name) != names->functions.end();
+  }
+
+  const Template& get_template() const {
+    return *tmpl;
+  }
+
+  const TemplateStorage& get_template_storage() const {
+    return *template_storage;
+  }
+
+  const FunctionStorage& get_function_storage() const {
+    return *function_storage;
+  }
+
+  const RenderConfig& get_render_config() const {
+    return render_config;
+  }
+};
+
+/*!
+ * \brief Per-thread render state for a CompiledTemplate.
+ *
+ * The renderer stacks and the output buffer are kept between renders, so rendering many pages with
+ * one context does not reallocate. A context must not be used by more than one thread at a time.
+ */
+class RenderContext {
+  CompiledTemplate compiled;
+  Renderer renderer;
+  std::string buffer;
+
+public:
+  explicit RenderContext(const CompiledTemplate& compiled)
+      : compiled(compiled), renderer(compiled.get_render_config(), compiled.get_template_storage(), compiled.get_function_storage()) {}
+
+  RenderContext(const RenderContext&) = delete;
+  RenderContext& operator=(const RenderContext&) = delete;
+
+  /// Renders into the internal buffer, the returned view is valid until the next render
+  std::string_view render(const json& data) {
+    buffer.clear();
+    StringSink sink(buffer);
+    render_to(sink, data);
+    return buffer;
+  }
+
+  void render_to(OutputSink& sink, const json& data) {
+    renderer.reset();
+    renderer.render_to(sink, compiled.get_template(), data);
+  }
+
+  /// Sets read-only data shared by all renders (e.g. site-wide values), looked up after the render data
+  void set_globals(const json& globals) {
+    renderer.set_globals(&globals);
+  }
+
+  /*!
+   * \brief Renders the template once for every data context in [first, last).
+   *
+   * `on_rendered(index, output)` is called after each render, the output view is only valid during the call.
+   * The iterator may also yield the json by value, e.g. to build each context lazily.
+   */
+  template <class InputIt, class Callback>
+  void render_batch(InputIt first, InputIt last, Callback&& on_rendered) {
+    for (size_t index = 0; first != last; ++first, ++index) {
+      const json& data = *first;
+      on_rendered(index, render(data));
+    }
+  }
+
+  const CompiledTemplate& get_compiled_template() const {
+    return compiled;
+  }
+};
+
+/*!
+ * \brief Class for changing the configuration.
+ */
+class Environment {
+  FunctionStorage function_storage;
+  std::shared_ptr<TemplateStorage> template_storage {std::make_shared<TemplateStorage>()};
+
+  /// Compiled templates share the storage, so it is copied before it is modified again
+  TemplateStorage& writable_template_storage() {
+    if (template_storage.use_count() > 1) {
+      template_storage = std::make_shared<TemplateStorage>(*template_storage);
+    }
+    return *template_storage;
+  }
+
+protected:
+  LexerConfig lexer_config;
+  ParserConfig parser_config;
+  RenderConfig render_config;
+
+  std::filesystem::path input_path;
+  std::filesystem::path output_path;
+  std::filesystem::path template_cache_path;
+
+public:
+  Environment(): Environment("") {}
+  explicit Environment(const std::filesystem::path& global_path): input_path(global_path), output_path(global_path) {}
+  Environment(const std::filesystem::path& input_path, const std::filesystem::path& output_path): input_path(input_path), output_path(output_path) {}
+
+  /// Sets the opener and closer for template statements
+  void set_statement(const std::string& open, const std::string& close) {
+    lexer_config.statement_open = open;
+    lexer_config.statement_open_no_lstrip = open + "+";
+    lexer_config.statement_open_force_lstrip = open + "-";
+    lexer_config.statement_close = close;
+    lexer_config.statement_close_force_rstrip = "-" + close;
+    lexer_config.update_open_chars();
+  }
+
+  /// Sets the opener for template line statements
+  void set_line_statement(const std::string& open) {
     lexer_config.line_statement = open;
     lexer_config.update_open_chars();
   }
@@ -2906,6 +4468,11 @@ public:
     parser_config.search_included_templates_in_files = search_in_files;
   }
 
+  /// Sets whether constant expressions are evaluated once after parsing
+  void set_constant_folding(bool fold_constants) {
+    parser_config.fold_constants = fold_constants;
+  }
+
   /// Sets whether a missing include will throw an error
   void set_throw_at_missing_includes(bool will_throw) {
     render_config.throw_at_missing_includes = will_throw;
@@ -2916,15 +4483,81 @@ public:
     render_config.html_autoescape = will_escape;
   }
 
+  /// Sets a directory for caching parsed templates on disk, an empty path disables the cache
+  void set_template_cache(const std::filesystem::path& directory) {
+    template_cache_path = directory;
+  }
+
+  static std::set<std::string> template_names(const TemplateStorage& storage) {
+    std::set<std::string> names;
+    for (const auto& entry : storage) {
+      names.insert(entry.first);
+    }
+    return names;
+  }
+
+  /// Names of all templates tmpl includes or extends, directly or through the templates it includes
+  static std::vector<std::string> referenced_template_names(const Template& tmpl, const TemplateStorage& storage) {
+    IncludeCollector collector;
+    tmpl.root.accept(collector);
+    for (size_t i = 0; i < collector.templates.size(); ++i) {
+      const auto it = storage.find(collector.templates[i]);
+      if (it != storage.end()) {
+        it->second.root.accept(collector);
+      }
+    }
+    return std::move(collector.templates);
+  }
+
+  static std::vector<std::string> added_template_names(const TemplateStorage& storage, const std::set<std::string>& known_names) {
+    std::vector<std::string> names;
+    for (const auto& entry : storage) {
+      if (known_names.count(entry.first) == 0) {
+        names.push_back(entry.first);
+      }
+    }
+    return names;
+  }
+
+  /// Folds constant expressions of a freshly parsed template and of the templates its parse added
+  void fold_constants(Template& tmpl, TemplateStorage& storage, const std::vector<std::string>& included_names) const {
+    if (!parser_config.fold_constants) {
+      return;
+    }
+    for (const auto& name : included_names) {
+      ConstantFolder::fold(storage.at(name), render_config, storage, function_storage);
+    }
+    ConstantFolder::fold(tmpl, render_config, storage, function_storage);
+  }
+
   Template parse(std::string_view input) {
-    Parser parser(parser_config, lexer_config, template_storage, function_storage);
-    return parser.parse(input, input_path);
+    TemplateStorage& storage = writable_template_storage();
+    Parser parser(parser_config, lexer_config, storage, function_storage);
+    const auto known_names = template_names(storage);
+    auto result = parser.parse(input, input_path);
+    fold_constants(result, storage, added_template_names(storage, known_names));
+    return result;
   }
 
   Template parse_template(const std::filesystem::path& filename) {
-    Parser parser(parser_config, lexer_config, template_storage, function_storage);
+    TemplateStorage& storage = writable_template_storage();
+    Parser parser(parser_config, lexer_config, storage, function_storage);
     auto result = Template(Parser::load_file(input_path / filename));
+
+    const TemplateCache cache(template_cache_path);
+    if (!template_cache_path.empty() && cache.load(input_path / filename, result, lexer_config, parser_config, storage, function_storage)) {
+      return result;
+    }
+
+    const auto known_names = template_names(storage);
     parser.parse_into_template(result, (input_path / filename).string());
+    const auto included_names = added_template_names(storage, known_names);
+    fold_constants(result, storage, included_names);
+
+    // Includes loaded by an earlier parse are dependencies as well, a new environment has to load them from the cache
+    if (!template_cache_path.empty()) {
+      cache.store(input_path / filename, result, lexer_config, parser_config, storage, referenced_template_names(result, storage));
+    }
     return result;
   }
 
@@ -2932,14 +4565,24 @@ public:
     return parse_template(filename);
   }
 
+  /// Freezes a parsed template with the current includes, callbacks and render config for concurrent rendering
+  CompiledTemplate compile(const Template& tmpl) const {
+    return CompiledTemplate(tmpl, template_storage, function_storage, render_config);
+  }
+
+  CompiledTemplate compile_template(const std::filesystem::path& filename) {
+    return compile(parse_template(filename));
+  }
+
   std::string render(std::string_view input, const json& data) {
     return render(parse(input), data);
   }
 
   std::string render(const Template& tmpl, const json& data) {
-    std::stringstream os;
-    render_to(os, tmpl, data);
-    return os.str();
+    std::string result;
+    StringSink sink(result);
+    render_to(sink, tmpl, data);
+    return result;
   }
 
   std::string render_file(const std::filesystem::path& filename, const json& data) {
@@ -2974,16 +4617,42 @@ public:
   }
 
   std::ostream& render_to(std::ostream& os, const Template& tmpl, const json& data) {
-    Renderer(render_config, template_storage, function_storage).render_to(os, tmpl, data);
+    Renderer(render_config, *template_storage, function_storage).render_to(os, tmpl, data);
     return os;
   }
 
+  /// Renders directly into the given sink, e.g. a reused StringSink or a FileDescriptorSink
+  OutputSink& render_to(OutputSink& sink, const Template& tmpl, const json& data) {
+    Renderer(render_config, *template_storage, function_storage).render_to(sink, tmpl, data);
+    return sink;
+  }
+
+  /*!
+   * \brief Renders a template once for every data context in [first, last).
+   *
+   * One renderer and output buffer are reused for all contexts. `on_rendered(index, output)` is called after each
+   * render, the output view is only valid during the call.
+   */
+  template <class InputIt, class Callback>
+  void render_batch(const Template& tmpl, InputIt first, InputIt last, Callback&& on_rendered) {
+    Renderer renderer(render_config, *template_storage, function_storage);
+    std::string result;
+    for (size_t index = 0; first != last; ++first, ++index) {
+      const json& data = *first;
+      result.clear();
+      StringSink sink(result);
+      renderer.reset();
+      renderer.render_to(sink, tmpl, data);
+      on_rendered(index, std::string_view(result));
+    }
+  }
+
   std::ostream& render_to(std::ostream& os, const std::string_view input, const json& data) {
     return render_to(os, parse(input), data);
   }
 
   std::string load_file(const std::string& filename) {
-    const Parser parser(parser_config, lexer_config, template_storage, function_storage);
+    const Parser parser(parser_config, lexer_config, *template_storage, function_storage);
     return Parser::load_file(input_path / filename);
   }
 
@@ -3033,7 +4702,7 @@ public:
    * include "<name>" syntax.
    */
   void include_template(const std::string& name, const Template& tmpl) {
-    template_storage[name] = tmpl;
+    writable_template_storage()[name] = tmpl;
   }
 
   /*!
@@ -20,26 +20,70 @@
  * - pantor/inja (Template engine)
  *
  * Compile:
- * g++ -std=c++23 -o ssg main5.cpp -lmd4c-html -lmd4c
+ * g++ -std=c++23 -o ssg main5.cpp -lmd4c
  */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <exception>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef SSG_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 // Libraries
 #include <inja.hpp>
-#include <md4c-html.h>
+#include <md4c.h>
 #include <nlohmann/json.hpp>
+#ifdef SSG_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
 
+#ifdef SSG_COMPILED_TEMPLATE
+// Generated by ssg_template_codegen (see ssg_compile_template in CMake)
+namespace ssg_compiled_template {
+extern const bool available;
+extern const std::uint64_t source_hash;
+void render(inja::OutputSink &out, const inja::json &data,
+            const inja::json &globals);
+} // namespace ssg_compiled_template
+#endif
+
 // --- Structures ---
 
 /**
@@ -49,16 +93,83 @@ struct Config {
   fs::path templatePath; ///< Path to the Inja template file.
   fs::path outputDir =
       "output_site"; ///< Directory where the site is generated.
+  unsigned threads = 0; ///< Render threads (0 = hardware concurrency).
+  fs::path templateCacheDir; ///< Cache for parsed templates (empty = off).
+  bool scopedNav = false; ///< Navigation shows only the current page's scope.
+  bool searchIndex = false; ///< Generate the client-side search index.
+  bool taxonomies = false;  ///< Generate year/author/tag listing pages.
+  size_t listingPageSize = 20; ///< Entries per listing page (0 = all).
+  std::string siteUrl;   ///< Absolute site URL, enables sitemap and feed.
+  std::string siteTitle; ///< Title of the feed (default: site URL).
+  bool sitemapGzip = false; ///< Compress the sitemap with gzip.
+  size_t feedSize = 20;     ///< Entries of the Atom feed.
+  bool ioUring = true;      ///< Write pages with io_uring where supported.
+};
+
+/**
+ * @brief Front matter of a page, read by the pre-scan before rendering.
+ */
+struct PageHeader {
+  std::string title;       ///< TITLE field (empty = file name).
+  long order = std::numeric_limits<long>::max(); ///< ORDER field.
+  bool draft = false;      ///< DRAFT field, drafts are not published.
+  json meta = json::object(); ///< All fields.
 };
 
 /**
  * @brief Directory node structure.
  */
 struct DirNode {
-  fs::path relativePath;        ///< Path relative to root.
-  std::string dirName;          ///< Name of the directory.
-  std::vector<fs::path> files;  ///< List of files in this directory.
-  std::vector<DirNode> subdirs; ///< List of subdirectories.
+  fs::path relativePath;           ///< Path relative to root.
+  std::string dirName;             ///< Name of the directory.
+  std::vector<fs::path> files;     ///< List of files in this directory.
+  std::vector<PageHeader> headers; ///< Header of each file (same order).
+  std::vector<DirNode> subdirs;    ///< List of subdirectories.
+};
+
+/**
+ * @brief Navigation tree with parent links, built once per site.
+ */
+struct NavTree {
+  /// A page or folder of the navigation.
+  struct Node {
+    std::string title;            ///< Label of the entry, HTML-escaped.
+    std::string href;             ///< Target relative to the site root.
+    int depth = 0;                ///< Nesting depth (top level: 0).
+    bool isFolder = false;        ///< Folder with its own list of entries.
+    size_t parent = 0;            ///< Index of the parent folder.
+    size_t order = 0;             ///< Position of a page in pageOrder.
+    std::vector<size_t> children; ///< Indexes of the entries of a folder.
+  };
+
+  std::vector<Node> nodes; ///< nodes[0] is the site root.
+  /// Page node by href, 0 for pages that are not in the navigation.
+  std::unordered_map<std::string, size_t> pageIndex;
+  std::vector<size_t> pageOrder; ///< Page nodes in pre-order (reading order).
+};
+
+/**
+ * @brief Site-wide state, built once and shared read-only by all pages.
+ */
+struct Site {
+  json globals;           ///< Template data of all pages (navigation model).
+  NavTree navTree;        ///< Navigation tree of the site.
+  bool scopedNav = false; ///< Pages get their own scoped navigation.
+};
+
+/**
+ * @brief A single page to generate, collected from the directory tree.
+ */
+struct Page {
+  fs::path inputPath;     ///< Source Markdown file.
+  fs::path outputPath;    ///< Generated HTML file.
+  std::string activePath; ///< Output file relative to the site root.
+  std::string backPrefix; ///< "../" sequence back to the site root.
+  std::string title;      ///< Page title.
+  const PageHeader *header = nullptr; ///< Pre-scanned front matter.
+  size_t navNode = 0;     ///< Node in the navigation tree, 0 = not in it.
+  std::string content;    ///< Generated HTML of pages without Markdown file.
+  json listing;           ///< Listing data of generated listing pages.
 };
 
 // --- Helpers ---
@@ -91,296 +202,3944 @@ void writeFile(const fs::path &path, std::string_view content) {
   out << content;
 }
 
-// --- NEW: Copy Assets ---
+// --- Logging ---
 
 /**
- * @brief Copies the 'assets' folder from the template directory to the output
- * directory.
- * @param templatePath Path to the template file.
- * @param outputRoot Path to the output directory.
+ * @brief Severity of a log message.
  */
-void copyAssets(const fs::path &templatePath, const fs::path &outputRoot) {
-  // The folder where the template is located (e.g. "my_theme/")
-  fs::path templateDir = templatePath.parent_path();
+enum class LogLevel { Error, Warning, Info, Verbose };
 
-  // The expected assets folder (e.g. "my_theme/assets")
-  fs::path sourceAssets = templateDir / "assets";
+/**
+ * @brief Buffered console log.
+ *
+ * Threads store their messages in a fixed ring of slots and return; a
+ * background thread writes them in batches every 100 ms (immediately for
+ * errors and warnings, or when the ring is half full). On a terminal, a
+ * progress bar of the generated pages is redrawn below the messages.
+ */
+class Logger {
+  static constexpr size_t ringSize = 1024;
+  static constexpr auto flushInterval = std::chrono::milliseconds(100);
 
-  // Target: "output/assets"
-  fs::path destAssets = outputRoot / "assets";
+  struct Entry {
+    LogLevel level = LogLevel::Info;
+    std::string text;
+  };
 
-  if (fs::exists(sourceAssets) && fs::is_directory(sourceAssets)) {
-    std::cout << "Found assets folder: " << sourceAssets.string() << std::endl;
+  const LogLevel threshold;
+  const bool terminal; ///< stdout is a TTY, draw the progress bar.
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
 
-    try {
-      // Create directories
-      fs::create_directories(destAssets);
+  std::mutex mutex; ///< Guards the ring and the flags below.
+  std::condition_variable wake;
+  std::condition_variable notFull;
+  std::array<Entry, ringSize> ring;
+  size_t readIndex = 0;
+  size_t writeIndex = 0;
+  bool urgent = false;   ///< A warning or error waits in the ring.
+  bool stopping = false;
+  bool stopped = false;  ///< No flush thread, messages are printed directly.
 
-      // Recursively copy and overwrite existing
-      fs::copy(sourceAssets, destAssets,
-               fs::copy_options::recursive |
-                   fs::copy_options::overwrite_existing);
+  std::atomic<size_t> pageCount{0};
+  std::atomic<size_t> pageTotal{0}; ///< 0 = no progress bar.
+  std::atomic<std::uint64_t> byteCount{0};
+  std::atomic<size_t> errorCount{0};
+  std::atomic<size_t> warningCount{0};
+  // Used by print() only: the flush thread, after stop() under the mutex
+  bool barVisible = false;
+  size_t barPages = 0; ///< Pages shown by the bar.
 
-      std::cout << "Assets successfully copied to: " << destAssets.string()
-                << std::endl;
-    } catch (const fs::filesystem_error &e) {
-      std::cerr << "Error copying assets: " << e.what() << std::endl;
+  std::jthread flusher;
+
+  void drawBar(std::string &out, size_t done, size_t total) const {
+    constexpr size_t width = 24;
+    const size_t filled = total > 0 ? done * width / total : width;
+    out += "\r[";
+    out.append(filled, '#');
+    out.append(width - filled, '.');
+    out += std::format("] {}/{} pages", done, total);
+  }
+
+  /// Writes a batch of messages, keeping the order across both streams.
+  void print(std::vector<Entry> &batch) {
+    const size_t total = pageTotal.load();
+    const size_t done = pageCount.load();
+    const bool bar = terminal && total > 0;
+    const bool barChanged =
+        bar ? (!barVisible || done != barPages) : barVisible;
+    if (batch.empty() && !barChanged)
+      return;
+
+    std::string out;
+    std::string err;
+    if (barVisible && (!batch.empty() || !bar)) {
+      std::cout << "\r\033[K";
+      barVisible = false;
     }
-  } else {
-    std::cout << "No assets folder found at: " << sourceAssets.string()
-              << " (skipping copy)" << std::endl;
+    for (auto &entry : batch) {
+      if (entry.level <= LogLevel::Warning) {
+        if (!out.empty())
+          std::cout << out << std::flush;
+        out.clear();
+        err += entry.level == LogLevel::Error ? "Error: " : "Warning: ";
+        err += entry.text;
+        err += '\n';
+      } else {
+        if (!err.empty())
+          std::cerr << err << std::flush;
+        err.clear();
+        out += entry.text;
+        out += '\n';
+      }
+    }
+    if (!err.empty())
+      std::cerr << err << std::flush;
+    if (bar) {
+      drawBar(out, done, total);
+      barVisible = true;
+      barPages = done;
+    }
+    std::cout << out << std::flush;
+    batch.clear();
   }
-}
 
-// --- Markdown Logic ---
+  /// Stores a message in the ring, blocks while the ring is full.
+  void push(LogLevel level, std::string text) {
+    std::unique_lock lock(mutex);
+    notFull.wait(lock, [&] {
+      return stopped || writeIndex - readIndex < ringSize;
+    });
+    if (stopped) {
+      std::vector<Entry> batch;
+      batch.push_back({level, std::move(text)});
+      print(batch);
+      return;
+    }
+    ring[writeIndex++ % ringSize] = {level, std::move(text)};
+    if (level <= LogLevel::Warning)
+      urgent = true;
+    if (urgent || writeIndex - readIndex >= ringSize / 2)
+      wake.notify_one();
+  }
+
+  void run() {
+    std::vector<Entry> batch;
+    std::unique_lock lock(mutex);
+    while (true) {
+      wake.wait_for(lock, flushInterval, [&] {
+        return stopping || urgent || writeIndex - readIndex >= ringSize / 2;
+      });
+      for (; readIndex != writeIndex; ++readIndex)
+        batch.push_back(std::move(ring[readIndex % ringSize]));
+      urgent = false;
+      notFull.notify_all();
+      const bool stop = stopping;
+      lock.unlock();
+      if (stop)
+        pageTotal = 0; // clear the bar before exiting
+      print(batch);
+      if (stop)
+        return;
+      lock.lock();
+    }
+  }
+
+public:
+  /**
+   * @param threshold Most detailed level that is printed.
+   */
+  explicit Logger(LogLevel threshold)
+      : threshold(threshold), terminal(isatty(STDOUT_FILENO) == 1),
+        flusher([this] { run(); }) {}
+
+  ~Logger() { stop(); }
+
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  /// True if messages of this level are printed.
+  bool enabled(LogLevel level) const { return level <= threshold; }
+
+  /**
+   * @brief Logs a message. Thread-safe, blocks only while the ring is full.
+   * @param level Severity.
+   * @param text Message without trailing newline.
+   */
+  void log(LogLevel level, std::string text) {
+    if (level == LogLevel::Error)
+      ++errorCount;
+    else if (level == LogLevel::Warning)
+      ++warningCount;
+    if (enabled(level))
+      push(level, std::move(text));
+  }
+
+  void error(std::string text) { log(LogLevel::Error, std::move(text)); }
+  void warning(std::string text) { log(LogLevel::Warning, std::move(text)); }
+  void info(std::string text) { log(LogLevel::Info, std::move(text)); }
+  void verbose(std::string text) { log(LogLevel::Verbose, std::move(text)); }
+
+  /**
+   * @brief Shows the progress bar (on a terminal).
+   * @param total Number of pages that will be generated.
+   */
+  void startProgress(size_t total) { pageTotal = total; }
+
+  /// Hides the progress bar.
+  void stopProgress() { pageTotal = 0; }
+
+  /**
+   * @brief Counts a generated page. Thread-safe.
+   * @param bytes Size of the page.
+   */
+  void pageWritten(size_t bytes) {
+    ++pageCount;
+    byteCount += bytes;
+  }
+
+  /// Number of errors logged so far.
+  size_t errors() const { return errorCount; }
+
+  /**
+   * @brief Prints the summary: pages, bytes, time, errors and warnings.
+   *
+   * Printed on stdout at every level, so --quiet still ends with it.
+   */
+  void summary() {
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    const double bytes = static_cast<double>(byteCount);
+    const std::string size = bytes < 1024 * 1024
+                                 ? std::format("{:.1f} KiB", bytes / 1024)
+                                 : std::format("{:.1f} MiB",
+                                               bytes / (1024 * 1024));
+    push(LogLevel::Info, std::format("Summary: {} pages, {}, {:.2f} s, {} errors, {} warnings",
+                     pageCount.load(), size, seconds, errorCount.load(),
+                     warningCount.load()));
+  }
+
+  /**
+   * @brief Writes all pending messages and stops the flush thread.
+   *
+   * Messages logged afterwards are printed directly.
+   */
+  void stop() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    if (flusher.joinable())
+      flusher.join();
+
+    // Messages logged while the flush thread finished
+    std::lock_guard lock(mutex);
+    std::vector<Entry> batch;
+    for (; readIndex != writeIndex; ++readIndex)
+      batch.push_back(std::move(ring[readIndex % ringSize]));
+    print(batch);
+    stopped = true;
+    notFull.notify_all();
+  }
+};
+
+// --- Output ---
 
 /**
- * @brief MD4C callback.
+ * @brief Destination of the generated site.
+ *
+ * All files are written with paths relative to the site root, either into a
+ * directory tree or sequentially into a single archive.
  */
-void md_process_output(const MD_CHAR *text, MD_SIZE size, void *userdata) {
-  std::string *out = static_cast<std::string *>(userdata);
-  out->append(text, size);
-}
+class SiteOutput {
+public:
+  virtual ~SiteOutput() = default;
+
+  /**
+   * @brief Writes a file. Thread-safe.
+   * @param path File relative to the site root.
+   * @param content Content of the file.
+   */
+  virtual void write(const fs::path &path, std::string_view content) = 0;
+
+  /**
+   * @brief Copies a file into the site. Thread-safe.
+   * @param path Target relative to the site root.
+   * @param source Source file.
+   */
+  virtual void copyFile(const fs::path &path, const fs::path &source) {
+    write(path, readFile(source));
+  }
+
+  /**
+   * @brief Creates the directories of the site in one pass.
+   * @param paths Directories relative to the site root.
+   */
+  virtual void createDirectories(const std::vector<fs::path> &) {}
+
+  /**
+   * @brief Completes the output (e.g. the archive trailer).
+   */
+  virtual void finish() {}
+};
 
 /**
- * @brief Renders Markdown to HTML.
- * @param mdContent Markdown string.
- * @return HTML string.
+ * @brief A file waiting to be written.
  */
-std::string renderMarkdown(const std::string &mdContent) {
-  std::string htmlOutput;
-  int ret = md_html(mdContent.c_str(), static_cast<MD_SIZE>(mdContent.size()),
-                    md_process_output, &htmlOutput, MD_DIALECT_GITHUB, 0);
-  if (ret != 0)
-    throw std::runtime_error("Markdown parsing failed.");
-  return htmlOutput;
-}
+struct PendingFile {
+  std::string path;    ///< Relative to the output directory.
+  std::string content; ///< Owned, the caller's buffer is reused.
+};
 
 /**
- * @brief Parses the configuration file.
- * @param configPath Path to config file.
- * @return Config object.
+ * @brief Bounded queue between the render threads and the file writers.
+ *
+ * push() blocks while the queue is full, so rendering cannot run arbitrarily
+ * far ahead of the disk.
  */
-Config parseConfig(const fs::path &configPath) {
-  Config cfg;
-  std::ifstream file(configPath);
-  if (!file)
-    throw std::runtime_error("Configuration file not found.");
-  std::string line;
-  while (std::getline(file, line)) {
-    auto delimiterPos = line.find('=');
-    if (delimiterPos != std::string::npos) {
-      std::string key = line.substr(0, delimiterPos);
-      std::string value = line.substr(delimiterPos + 1);
+class WriteQueue {
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  std::deque<PendingFile> files;
+  size_t capacity;
+  bool closed = false;
 
-      if (key == "template")
-        cfg.templatePath = value;
-      else if (key == "output")
-        cfg.outputDir = value;
+public:
+  explicit WriteQueue(size_t capacity) : capacity(capacity) {}
+
+  void push(PendingFile file) {
+    std::unique_lock lock(mutex);
+    notFull.wait(lock, [&] { return files.size() < capacity; });
+    files.push_back(std::move(file));
+    notEmpty.notify_one();
+  }
+
+  /**
+   * @brief Takes up to maxCount files.
+   * @param out Receives the files.
+   * @param maxCount Maximum number of files.
+   * @param wait Block until a file arrives or the queue is closed.
+   * @return False once the queue is closed and empty.
+   */
+  bool pop(std::vector<PendingFile> &out, size_t maxCount, bool wait) {
+    std::unique_lock lock(mutex);
+    if (wait)
+      notEmpty.wait(lock, [&] { return !files.empty() || closed; });
+    for (; maxCount > 0 && !files.empty(); --maxCount) {
+      out.push_back(std::move(files.front()));
+      files.pop_front();
     }
+    notFull.notify_all();
+    return !(closed && files.empty());
   }
-  return cfg;
-}
 
-// --- Logic: Build Tree (MD only) ---
+  /// Wakes all writers, they exit once the queue is drained.
+  void close() {
+    std::lock_guard lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+  }
+};
 
+#ifdef SSG_HAVE_IO_URING
 /**
- * @brief Builds the directory tree, filtering for .md files.
- * @param currentPath Current scanning path.
- * @param rootPath Root input path.
- * @return DirNode structure.
+ * @brief Minimal io_uring instance on the raw kernel interface.
+ *
+ * Owned by a single thread: SQEs are prepared with next(), handed to the
+ * kernel with submit() and reaped with reap().
  */
-DirNode buildTree(const fs::path &currentPath, const fs::path &rootPath) {
-  DirNode node;
-  node.dirName = currentPath.filename().string();
-  node.relativePath = fs::relative(currentPath, rootPath);
-  if (node.relativePath == ".")
-    node.relativePath = "";
+class IoUring {
+  int ringFd = -1;
+  void *sqRing = MAP_FAILED;
+  void *cqRing = MAP_FAILED;
+  size_t sqRingSize = 0;
+  size_t cqRingSize = 0;
+  io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  size_t sqesSize = 0;
 
-  for (const auto &entry : fs::directory_iterator(currentPath)) {
-    if (entry.is_directory()) {
-      node.subdirs.push_back(buildTree(entry.path(), rootPath));
-    } else if (entry.is_regular_file()) {
-      if (entry.path().extension() == ".md") {
-        node.files.push_back(entry.path().filename());
-      }
-    }
+  unsigned *sqHead = nullptr;
+  unsigned *sqTail = nullptr;
+  unsigned *sqArray = nullptr;
+  unsigned sqMask = 0;
+  unsigned sqEntries = 0;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  io_uring_cqe *cqes = nullptr;
+  unsigned cqMask = 0;
+  unsigned localTail = 0; ///< Prepared, not yet published SQEs.
+  unsigned submitted = 0; ///< Published SQEs.
+
+  template <class T> static T *at(void *base, unsigned offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
   }
-  std::ranges::sort(node.subdirs, {}, &DirNode::dirName);
-  std::ranges::sort(node.files);
-  return node;
-}
 
-/**
- * @brief Generates back references (../) for relative paths.
- * @param currentRelPath Current relative path.
- * @return String with "../" sequences.
- */
-std::string getBackPrefix(const fs::path &currentRelPath) {
-  std::string prefix = "";
-  for (const auto &_ : currentRelPath) {
-    prefix += "../";
+  void release() {
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+      munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+      munmap(sqRing, sqRingSize);
+    if (ringFd >= 0)
+      ::close(ringFd);
   }
-  return prefix;
-}
 
-/**
- * @brief Converts filename extension from .md to .html.
- * @param sourceFile Source filename.
- * @return Target filename.
- */
-fs::path getTargetFilename(const fs::path &sourceFile) {
-  fs::path p = sourceFile;
-  if (p.extension() == ".md")
-    p.replace_extension(".html");
-  return p;
-}
+public:
+  /**
+   * @param entries Size of the submission queue.
+   * @throws std::runtime_error if io_uring is not available.
+   */
+  explicit IoUring(unsigned entries) {
+    io_uring_params params{};
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0)
+      throw std::runtime_error("io_uring is not available.");
 
-// --- Navigation Generator ---
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+      sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+      release();
+      throw std::runtime_error("io_uring: could not map the rings.");
+    }
+    cqRing = (params.features & IORING_FEAT_SINGLE_MMAP)
+                 ? sqRing
+                 : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = static_cast<io_uring_sqe *>(
+        mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (cqRing == MAP_FAILED || sqes == MAP_FAILED) {
+      release();
+      throw std::runtime_error("io_uring: could not map the rings.");
+    }
 
-/**
- * @brief Generates Navigation HTML.
- * @param currentNode Current node.
- * @param html Output HTML string.
- * @param urlPrefix URL prefix.
- * @param activeTargetFile Active file for highlighting.
- */
-void generateNavHtml(const DirNode &currentNode, std::string &html,
-                     const std::string &urlPrefix,
-                     const fs::path &activeTargetFile) {
+    sqHead = at<unsigned>(sqRing, params.sq_off.head);
+    sqTail = at<unsigned>(sqRing, params.sq_off.tail);
+    sqArray = at<unsigned>(sqRing, params.sq_off.array);
+    sqMask = *at<unsigned>(sqRing, params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    cqHead = at<unsigned>(cqRing, params.cq_off.head);
+    cqTail = at<unsigned>(cqRing, params.cq_off.tail);
+    cqes = at<io_uring_cqe>(cqRing, params.cq_off.cqes);
+    cqMask = *at<unsigned>(cqRing, params.cq_off.ring_mask);
+    localTail = submitted = *sqTail;
+  }
 
-  html += "<ul class=\"nav-list\">\n";
+  ~IoUring() { release(); }
 
-  for (const auto &file : currentNode.files) {
-    std::string nameNoExt = file.stem().string();
-    fs::path targetFile = getTargetFilename(file);
-    fs::path fullLinkPath = currentNode.relativePath / targetFile;
-    std::string href = urlPrefix + fullLinkPath.generic_string();
+  IoUring(const IoUring &) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+
+  /**
+   * @brief Registers an empty table of direct descriptors.
+   * @param count Number of slots.
+   * @return False if the kernel does not support it.
+   */
+  bool registerFileSlots(unsigned count) {
+    io_uring_rsrc_register reg{};
+    reg.nr = count;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    return syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_FILES2,
+                   &reg, sizeof(reg)) == 0;
+  }
 
-    std::string classAttr =
-        (fullLinkPath == activeTargetFile) ? " class=\"active\"" : "";
+  /**
+   * @brief Tests opening a file into a direct descriptor and closing it.
+   *
+   * Kernels before 5.15 accept IORING_REGISTER_FILES2 but ignore the
+   * file_index of IORING_OP_OPENAT and IORING_OP_CLOSE. Call after
+   * registerFileSlots(), uses the first slot.
+   *
+   * @param dirFd Directory opened for the test.
+   * @return False if direct descriptors are not supported.
+   */
+  bool probeDirectOpen(int dirFd) {
+    // Direct opens return 0, which must not be a new normal descriptor
+    if (fcntl(0, F_GETFD) < 0)
+      return false;
+    auto run = [this](auto prepare) {
+      prepare(next());
+      submit(1);
+      int result = -EINVAL;
+      reap([&](std::uint64_t, int res) { result = res; });
+      return result;
+    };
 
-    html += std::format("  <li><a href=\"{}\"{}>{}</a></li>\n", href, classAttr,
-                        nameNoExt);
+    const int opened = run([dirFd](io_uring_sqe &sqe) {
+      sqe.opcode = IORING_OP_OPENAT;
+      sqe.fd = dirFd;
+      sqe.addr = reinterpret_cast<std::uint64_t>(".");
+      sqe.open_flags = O_RDONLY | O_DIRECTORY; // O_CLOEXEC is invalid here
+      sqe.file_index = 1;
+    });
+    if (opened > 0)
+      ::close(opened); // file_index was ignored
+    if (opened != 0)
+      return false;
+    return run([](io_uring_sqe &sqe) {
+             sqe.opcode = IORING_OP_CLOSE;
+             sqe.file_index = 1;
+           }) == 0;
   }
 
-  for (const auto &sub : currentNode.subdirs) {
-    size_t fileCount = sub.files.size();
-    if (fileCount == 1) {
-      fs::path targetFile = getTargetFilename(sub.files[0]);
-      fs::path linkPath = sub.relativePath / targetFile;
-      std::string href = urlPrefix + linkPath.generic_string();
-      std::string classAttr =
-          (linkPath == activeTargetFile) ? " class=\"active\"" : "";
-
-      html += std::format("  <li><a href=\"{}\"{}>{}</a></li>\n", href,
-                          classAttr, sub.dirName);
-    } else {
-      html += std::format("  <li><strong>{}</strong>\n", sub.dirName);
-      generateNavHtml(sub, html, urlPrefix, activeTargetFile);
-      html += "  </li>\n";
+  /// Free SQEs.
+  unsigned space() const {
+    return sqEntries -
+           (localTail - std::atomic_ref(*sqHead).load(std::memory_order_acquire));
+  }
+
+  /// Next SQE, cleared. Check space() first.
+  io_uring_sqe &next() {
+    const unsigned index = localTail++ & sqMask;
+    sqArray[index] = index;
+    sqes[index] = io_uring_sqe{};
+    return sqes[index];
+  }
+
+  /**
+   * @brief Submits the prepared SQEs.
+   * @param waitCount Completions to wait for.
+   */
+  void submit(unsigned waitCount) {
+    std::atomic_ref(*sqTail).store(localTail, std::memory_order_release);
+    const unsigned count = localTail - submitted;
+    submitted = localTail;
+    while (syscall(__NR_io_uring_enter, ringFd, count, waitCount,
+                   waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr,
+                   0) < 0) {
+      if (errno != EINTR)
+        throw std::runtime_error("io_uring_enter failed.");
     }
   }
-  html += "</ul>\n";
-}
 
-// --- Processing with Inja ---
+  /**
+   * @brief Waits for a completion without throwing, submitting the SQEs the
+   * kernel has not consumed yet (e.g. after submit() failed).
+   * @return False if io_uring_enter fails.
+   */
+  bool wait() noexcept {
+    const unsigned unconsumed =
+        localTail - std::atomic_ref(*sqHead).load(std::memory_order_acquire);
+    submitted = localTail;
+    return syscall(__NR_io_uring_enter, ringFd, unconsumed, 1,
+                   IORING_ENTER_GETEVENTS, nullptr, 0) >= 0 ||
+           errno == EINTR;
+  }
+
+  /**
+   * @brief Calls onCompletion(userData, result) for every completion.
+   */
+  template <class Callback> void reap(Callback &&onCompletion) {
+    unsigned head = *cqHead;
+    const unsigned tail =
+        std::atomic_ref(*cqTail).load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      const io_uring_cqe &cqe = cqes[head & cqMask];
+      onCompletion(cqe.user_data, cqe.res);
+    }
+    std::atomic_ref(*cqHead).store(head, std::memory_order_release);
+  }
+};
+#endif
 
 /**
- * @brief Processes files using Inja templates.
- * @param currentNode Current node.
- * @param rootNode Root node.
- * @param inputRoot Input root.
- * @param cfg Config.
- * @param env Inja environment.
- * @param tmpl Parsed Inja template.
+ * @brief Writes the site into a directory tree.
+ *
+ * Files are written asynchronously: write() hands the content to a bounded
+ * queue and returns. With io_uring, a single writer thread submits
+ * open/write/close as linked requests on direct descriptors, keeping up to
+ * 256 files in flight with one system call per batch. Without io_uring a
+ * small thread pool writes the files.
  */
-void processFiles(const DirNode &currentNode, const DirNode &rootNode,
-                  const fs::path &inputRoot, const Config &cfg,
-                  inja::Environment &env, const inja::Template &tmpl) {
+class DirectoryOutput : public SiteOutput {
+  static constexpr unsigned maxInFlight = 256;
+  /// Larger files are written synchronously instead of being queued.
+  static constexpr size_t maxQueuedSize = 64 << 20;
 
-  fs::path currentOutputDir = cfg.outputDir / currentNode.relativePath;
-  fs::create_directories(currentOutputDir);
-  std::string backPrefix = getBackPrefix(currentNode.relativePath);
+  fs::path root;
+  std::mutex mutex;                            ///< Guards directories.
+  std::unordered_set<std::string> directories; ///< Directories that exist.
+  WriteQueue queue{2 * maxInFlight};
+  std::mutex errorMutex; ///< Guards error.
+  std::string error;     ///< First failed write.
+  std::vector<std::jthread> writers;
 
-  for (const auto &file : currentNode.files) {
-    fs::path inputPath = inputRoot / currentNode.relativePath / file;
-    fs::path targetFilename = getTargetFilename(file);
-    fs::path outputPath = currentOutputDir / targetFilename;
-    fs::path currentActiveFile = currentNode.relativePath / targetFilename;
+  /// Creates the parent directory of a file once.
+  void createParent(const fs::path &path) {
+    const fs::path parent = path.parent_path();
+    std::lock_guard lock(mutex);
+    if (directories.insert(parent.generic_string()).second)
+      fs::create_directories(root / parent);
+  }
 
-    std::string navHtml;
-    generateNavHtml(rootNode, navHtml, backPrefix, currentActiveFile);
+  void fail(const std::string &message) {
+    std::lock_guard lock(errorMutex);
+    if (error.empty())
+      error = message;
+  }
+
+  /// Thread pool fallback: every writer writes one file at a time.
+  void poolWriter() {
+    std::vector<PendingFile> files;
+    // The last files arrive with the end of the queue
+    for (bool open = true; open;) {
+      open = queue.pop(files, 1, true);
+      for (const auto &file : files) {
+        try {
+          writeFile(root / file.path, file.content);
+        } catch (const std::exception &e) {
+          fail(e.what());
+        }
+      }
+      files.clear();
+    }
+  }
 
-    std::string rawContent = readFile(inputPath);
-    std::string htmlContent = renderMarkdown(rawContent);
+#ifdef SSG_HAVE_IO_URING
+  /**
+   * @brief io_uring writer: open, write and close are one linked chain per
+   * file.
+   *
+   * If the ring fails, the requests in flight are drained before their
+   * buffers are released, and the files that were not written are written by
+   * this thread, which then continues as a pool writer.
+   */
+  void uringWriter(IoUring &ring, int rootFd) {
+    enum : std::uint64_t { Open, Write, Close };
+    struct Slot {
+      PendingFile file;
+      int pending = 0;      ///< Outstanding completions.
+      bool written = false; ///< The write completed in full.
+    };
+    std::vector<Slot> slots(maxInFlight);
+    std::vector<unsigned> freeSlots;
+    for (unsigned i = maxInFlight; i-- > 0;)
+      freeSlots.push_back(i);
+    std::vector<PendingFile> batch;
+    std::vector<PendingFile> unfinished; ///< Failed chains while draining.
+    bool open = true;
+    bool draining = false;
 
-    json data;
-    data["base_path"] = backPrefix;
-    data["title"] = file.stem().string();
-    data["navigation"] = navHtml;
-    data["content"] = htmlContent;
+    auto onCompletion = [&](std::uint64_t userData, int result) {
+      const unsigned index = static_cast<unsigned>(userData >> 2);
+      Slot &slot = slots[index];
+      const auto op = userData & 3;
+      if (op == Write && result >= 0 &&
+          static_cast<size_t>(result) == slot.file.content.size())
+        slot.written = true;
+      // While draining, failed files are written again below
+      else if (!draining && result < 0 && result != -ECANCELED)
+        fail(std::format("Could not write file: {} ({})",
+                         (root / slot.file.path).string(),
+                         std::strerror(-result)));
+      else if (!draining && op == Write && result >= 0)
+        fail(std::format("Could not write file: {}",
+                         (root / slot.file.path).string()));
+      if (--slot.pending == 0) {
+        if (draining && !slot.written)
+          unfinished.push_back(std::move(slot.file));
+        slot.file = {};
+        freeSlots.push_back(index);
+      }
+    };
 
     try {
-      std::string finalResult = env.render(tmpl, data);
-      writeFile(outputPath, finalResult);
-      std::cout << "Created: " << outputPath.string() << std::endl;
-    } catch (const std::exception &e) {
-      std::cerr << "Template Error in " << file.string() << ": " << e.what()
-                << std::endl;
+      while (open || freeSlots.size() < maxInFlight) {
+        const bool idle = freeSlots.size() == maxInFlight;
+        if (open)
+          open = queue.pop(batch, std::min<size_t>(freeSlots.size(),
+                                                    ring.space() / 3),
+                           idle);
+        for (auto &file : batch) {
+          const unsigned index = freeSlots.back();
+          freeSlots.pop_back();
+          Slot &slot = slots[index];
+          slot.file = std::move(file);
+          slot.pending = 3;
+          slot.written = false;
+
+          io_uring_sqe &openSqe = ring.next();
+          openSqe.opcode = IORING_OP_OPENAT;
+          openSqe.fd = rootFd;
+          openSqe.addr =
+              reinterpret_cast<std::uint64_t>(slot.file.path.c_str());
+          openSqe.len = 0644;
+          openSqe.open_flags = O_WRONLY | O_CREAT | O_TRUNC;
+          openSqe.file_index = index + 1;
+          openSqe.flags = IOSQE_IO_LINK;
+          openSqe.user_data = (std::uint64_t{index} << 2) | Open;
+
+          io_uring_sqe &writeSqe = ring.next();
+          writeSqe.opcode = IORING_OP_WRITE;
+          writeSqe.fd = static_cast<int>(index);
+          writeSqe.addr =
+              reinterpret_cast<std::uint64_t>(slot.file.content.data());
+          writeSqe.len = static_cast<unsigned>(slot.file.content.size());
+          writeSqe.flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+          writeSqe.user_data = (std::uint64_t{index} << 2) | Write;
+
+          io_uring_sqe &closeSqe = ring.next();
+          closeSqe.opcode = IORING_OP_CLOSE;
+          closeSqe.file_index = index + 1;
+          closeSqe.user_data = (std::uint64_t{index} << 2) | Close;
+        }
+        const bool waitForSlot = batch.empty() || freeSlots.empty();
+        batch.clear();
+        if (freeSlots.size() == maxInFlight)
+          continue;
+
+        ring.submit(waitForSlot ? 1 : 0);
+        ring.reap(onCompletion);
+      }
+      return;
+    } catch (const std::exception &) {
+      // Continue below: drain the ring, then write without it
     }
+
+    // The kernel may still read the paths and contents of the slots
+    draining = true;
+    while (freeSlots.size() < maxInFlight) {
+      if (!ring.wait()) {
+        for (const auto &slot : slots) {
+          if (slot.pending > 0 && !slot.written)
+            unfinished.push_back(slot.file);
+        }
+        // Never released: requests may still read from the slots
+        new std::vector<Slot>(std::move(slots));
+        break;
+      }
+      ring.reap(onCompletion);
+    }
+    for (const auto &file : unfinished) {
+      try {
+        writeFile(root / file.path, file.content);
+      } catch (const std::exception &e) {
+        fail(e.what());
+      }
+    }
+    poolWriter();
   }
+#endif
 
-  for (const auto &sub : currentNode.subdirs) {
-    processFiles(sub, rootNode, inputRoot, cfg, env, tmpl);
+  /**
+   * @brief Starts the io_uring writer, or the thread pool if io_uring is
+   * disabled, unavailable or lacks direct descriptors.
+   * @param ioUring Use io_uring where supported.
+   */
+  void startWriters([[maybe_unused]] bool ioUring) {
+#ifdef SSG_HAVE_IO_URING
+    const int rootFd =
+        ioUring ? ::open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)
+                : -1;
+    if (rootFd >= 0) {
+      try {
+        auto ring = std::make_shared<IoUring>(4 * maxInFlight);
+        if (ring->registerFileSlots(maxInFlight) &&
+            ring->probeDirectOpen(rootFd)) {
+          writers.emplace_back([this, ring, rootFd] {
+            try {
+              uringWriter(*ring, rootFd);
+            } catch (const std::exception &e) {
+              fail(e.what());
+              // Keep draining so that producers do not block forever
+              poolWriter();
+            }
+            ::close(rootFd);
+          });
+          return;
+        }
+      } catch (const std::exception &) {
+        // Fall back to the thread pool
+      }
+      ::close(rootFd);
+    }
+#endif
+    const unsigned count =
+        std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+    for (unsigned i = 0; i < count; ++i)
+      writers.emplace_back([this] { poolWriter(); });
   }
-}
 
-/**
- * @brief Main entry point.
- */
-int main(int argc, char *argv[]) {
-  if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <path_to_config> <input_folder>"
-              << std::endl;
-    return 1;
+public:
+  /**
+   * @param root Output directory, created empty.
+   * @param ioUring Use io_uring where supported (false: thread pool).
+   */
+  explicit DirectoryOutput(fs::path root, bool ioUring = true)
+      : root(std::move(root)) {
+    if (fs::exists(this->root))
+      fs::remove_all(this->root);
+    fs::create_directories(this->root);
+    directories.insert("");
+    startWriters(ioUring);
   }
 
-  fs::path configPath = argv[1];
-  fs::path inputDir = argv[2];
+  ~DirectoryOutput() override {
+    queue.close();
+    writers.clear();
+  }
 
-  try {
-    Config cfg = parseConfig(configPath);
+  void createDirectories(const std::vector<fs::path> &paths) override {
+    // Parents sort before their children, so one mkdir per directory
+    std::vector<std::string> all;
+    for (const auto &path : paths) {
+      for (fs::path dir = path; !dir.empty(); dir = dir.parent_path())
+        all.push_back(dir.generic_string());
+    }
+    std::ranges::sort(all);
+    const auto [first, last] = std::ranges::unique(all);
+    all.erase(first, last);
 
-    if (!fs::exists(inputDir))
-      throw std::runtime_error("Input folder does not exist.");
-    if (!fs::exists(cfg.templatePath))
-      throw std::runtime_error("Template file does not exist.");
+    std::lock_guard lock(mutex);
+    for (auto &dir : all) {
+      if (!directories.contains(dir)) {
+        fs::create_directory(root / dir);
+        directories.insert(std::move(dir));
+      }
+    }
+  }
 
-    std::cout << "Scanning structure (.md only)..." << std::endl;
-    DirNode rootNode = buildTree(inputDir, inputDir);
+  void write(const fs::path &path, std::string_view content) override {
+    createParent(path);
+    if (content.size() > maxQueuedSize)
+      writeFile(root / path, content);
+    else
+      queue.push({path.generic_string(), std::string(content)});
+  }
+
+  void copyFile(const fs::path &path, const fs::path &source) override {
+    createParent(path);
+    fs::copy_file(source, root / path, fs::copy_options::overwrite_existing);
+  }
 
-    if (fs::exists(cfg.outputDir))
-      fs::remove_all(cfg.outputDir);
-    fs::create_directories(cfg.outputDir);
+  void finish() override {
+    queue.close();
+    writers.clear();
+    if (!error.empty())
+      throw std::runtime_error(error);
+  }
+};
 
-    // --- NEW: Copy Assets ---
-    // Copies assets from the folder where template.html is located
-    copyAssets(cfg.templatePath, cfg.outputDir);
+/**
+ * @brief Sequential archive file with a large write buffer.
+ */
+class ArchiveFile {
+  static constexpr size_t bufferSize = 1 << 20;
 
-    std::cout << "Loading template..." << std::endl;
-    inja::Environment env;
-    inja::Template tmpl = env.parse_template(cfg.templatePath.string());
+  fs::path path;
+  int fd = -1;
+#ifdef SSG_HAVE_ZLIB
+  gzFile gzipFile = nullptr;
+#endif
+  std::string buffer;
+  std::uint64_t position = 0;
 
-    std::cout << "Generating pages with Inja..." << std::endl;
-    processFiles(rootNode, rootNode, inputDir, cfg, env, tmpl);
+  void writeOut(std::string_view data) {
+#ifdef SSG_HAVE_ZLIB
+    if (gzipFile != nullptr) {
+      if (gzwrite(gzipFile, data.data(), static_cast<unsigned>(data.size())) !=
+          static_cast<int>(data.size()))
+        throw std::runtime_error(
+            std::format("Could not write file: {}", path.string()));
+      return;
+    }
+#endif
+    while (!data.empty()) {
+      const ssize_t count = ::write(fd, data.data(), data.size());
+      if (count < 0 && errno == EINTR)
+        continue;
+      if (count < 0)
+        throw std::runtime_error(
+            std::format("Could not write file: {}", path.string()));
+      data.remove_prefix(static_cast<size_t>(count));
+    }
+  }
 
-    std::cout << "Done! Output in: " << cfg.outputDir.string() << std::endl;
+  void flush() {
+    writeOut(buffer);
+    buffer.clear();
+  }
 
-  } catch (const std::exception &e) {
-    std::cerr << "Error: " << e.what() << std::endl;
-    return 1;
+public:
+  /**
+   * @param path Path to the archive.
+   * @param gzip Compress the archive with gzip.
+   */
+  ArchiveFile(fs::path path, bool gzip) : path(std::move(path)) {
+    if (gzip) {
+#ifdef SSG_HAVE_ZLIB
+      gzipFile = gzopen(this->path.c_str(), "wb");
+      if (gzipFile == nullptr)
+        throw std::runtime_error(
+            std::format("Could not write file: {}", this->path.string()));
+#else
+      throw std::runtime_error("gzip output requires ssg5 built with zlib.");
+#endif
+    } else {
+      fd = ::open(this->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644);
+      if (fd < 0)
+        throw std::runtime_error(
+            std::format("Could not write file: {}", this->path.string()));
+    }
+    buffer.reserve(bufferSize);
   }
 
-  return 0;
-}
\ No newline at end of file
+  ~ArchiveFile() {
+    if (fd >= 0)
+      ::close(fd);
+#ifdef SSG_HAVE_ZLIB
+    if (gzipFile != nullptr)
+      gzclose(gzipFile);
+#endif
+  }
+
+  ArchiveFile(const ArchiveFile &) = delete;
+  ArchiveFile &operator=(const ArchiveFile &) = delete;
+
+  void write(std::string_view data) {
+    position += data.size();
+    if (buffer.size() + data.size() > bufferSize)
+      flush();
+    if (data.size() >= bufferSize)
+      writeOut(data);
+    else
+      buffer.append(data);
+  }
+
+  /// Writes zero bytes up to the next multiple of blockSize.
+  void pad(size_t blockSize) {
+    static constexpr std::array<char, 512> zeros{};
+    const size_t rest = position % blockSize;
+    if (rest != 0)
+      write(std::string_view(zeros.data(), blockSize - rest));
+  }
+
+  /// Uncompressed bytes written so far.
+  std::uint64_t offset() const { return position; }
+
+  /// Flushes and closes the file.
+  void close() {
+    flush();
+    int result = 0;
+    if (fd >= 0)
+      result = ::close(fd);
+    fd = -1;
+#ifdef SSG_HAVE_ZLIB
+    if (gzipFile != nullptr)
+      result = gzclose(gzipFile);
+    gzipFile = nullptr;
+#endif
+    if (result != 0)
+      throw std::runtime_error(
+          std::format("Could not write file: {}", path.string()));
+  }
+};
+
+/**
+ * @brief Writes the site into a tar archive (GNU format), optionally gzip
+ * compressed.
+ */
+class TarOutput : public SiteOutput {
+  std::mutex mutex; ///< Guards file.
+  ArchiveFile file;
+  std::uint64_t mtime;
+
+  static void putOctal(char *field, size_t width, std::uint64_t value) {
+    field[width - 1] = '\0';
+    for (size_t i = width - 1; i-- > 0; value >>= 3)
+      field[i] = static_cast<char>('0' + (value & 7));
+  }
+
+  void writeHeader(std::string_view name, std::uint64_t size, char type) {
+    std::array<char, 512> header{};
+    std::ranges::copy(name.substr(0, 100), header.data());
+    putOctal(&header[100], 8, 0644);
+    putOctal(&header[108], 8, 0);
+    putOctal(&header[116], 8, 0);
+    putOctal(&header[124], 12, size);
+    putOctal(&header[136], 12, mtime);
+    header[156] = type;
+    std::ranges::copy(std::string_view("ustar  "), &header[257]);
+
+    // The checksum is computed with the checksum field set to spaces
+    std::ranges::fill_n(&header[148], 8, ' ');
+    unsigned checksum = 0;
+    for (char ch : header)
+      checksum += static_cast<unsigned char>(ch);
+    putOctal(&header[148], 7, checksum);
+    file.write(std::string_view(header.data(), header.size()));
+  }
+
+public:
+  /**
+   * @param path Path to the archive.
+   * @param gzip Compress the archive with gzip.
+   */
+  TarOutput(const fs::path &path, bool gzip)
+      : file(path, gzip),
+        mtime(static_cast<std::uint64_t>(std::time(nullptr))) {}
+
+  void write(const fs::path &path, std::string_view content) override {
+    const std::string name = path.generic_string();
+    std::lock_guard lock(mutex);
+    // Longer names are stored in a preceding GNU long name entry
+    if (name.size() > 100) {
+      writeHeader("././@LongLink", name.size() + 1, 'L');
+      file.write(std::string_view(name.c_str(), name.size() + 1));
+      file.pad(512);
+    }
+    writeHeader(name, content.size(), '0');
+    file.write(content);
+    file.pad(512);
+  }
+
+  void finish() override {
+    std::lock_guard lock(mutex);
+    file.write(std::string(1024, '\0'));
+    file.close();
+  }
+};
+
+/**
+ * @brief CRC-32 of the zip format.
+ * @param data Data.
+ * @return Checksum.
+ */
+std::uint32_t checksumCrc32(std::string_view data) {
+  static constexpr auto table = [] {
+    std::array<std::uint32_t, 256> result{};
+    for (std::uint32_t i = 0; i < result.size(); ++i) {
+      std::uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit)
+        value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+      result[i] = value;
+    }
+    return result;
+  }();
+
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (unsigned char ch : data)
+    crc = table[(crc ^ ch) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Writes the site into a zip archive with stored (uncompressed)
+ * entries. Zip64 records are added when the archive needs them.
+ */
+class ZipOutput : public SiteOutput {
+  static constexpr std::uint32_t maxField = 0xFFFFFFFFu;
+
+  /// Central directory entry.
+  struct Entry {
+    std::string name;
+    std::uint32_t crc;
+    std::uint32_t size;
+    std::uint64_t offset;
+  };
+
+  std::mutex mutex; ///< Guards file and entries.
+  ArchiveFile file;
+  std::vector<Entry> entries;
+  std::uint16_t dosTime = 0;
+  std::uint16_t dosDate = 0;
+
+  /// Appends a little-endian number of the given width.
+  static void put(std::string &out, std::uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i, value >>= 8)
+      out += static_cast<char>(value & 0xFF);
+  }
+
+public:
+  /**
+   * @param path Path to the archive.
+   */
+  explicit ZipOutput(const fs::path &path) : file(path, false) {
+    const std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    dosTime = static_cast<std::uint16_t>(
+        (local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    dosDate = static_cast<std::uint16_t>(((local.tm_year - 80) << 9) |
+                                         ((local.tm_mon + 1) << 5) |
+                                         local.tm_mday);
+  }
+
+  void write(const fs::path &path, std::string_view content) override {
+    if (content.size() >= maxField)
+      throw std::runtime_error(
+          std::format("File too large for zip output: {}", path.string()));
+    Entry entry{path.generic_string(), checksumCrc32(content),
+                static_cast<std::uint32_t>(content.size()), 0};
+
+    std::string header;
+    put(header, 0x04034b50, 4); // local file header
+    put(header, 20, 2);         // version needed
+    put(header, 0x0800, 2);     // UTF-8 names
+    put(header, 0, 2);          // stored
+    put(header, dosTime, 2);
+    put(header, dosDate, 2);
+    put(header, entry.crc, 4);
+    put(header, entry.size, 4);
+    put(header, entry.size, 4);
+    put(header, entry.name.size(), 2);
+    put(header, 0, 2);
+    header += entry.name;
+
+    std::lock_guard lock(mutex);
+    entry.offset = file.offset();
+    file.write(header);
+    file.write(content);
+    entries.push_back(std::move(entry));
+  }
+
+  void finish() override {
+    std::lock_guard lock(mutex);
+    const std::uint64_t directoryOffset = file.offset();
+    for (const auto &entry : entries) {
+      const bool zip64 = entry.offset >= maxField;
+      std::string header;
+      put(header, 0x02014b50, 4);    // central directory header
+      put(header, (3 << 8) | 45, 2); // made by Unix
+      put(header, zip64 ? 45 : 20, 2);
+      put(header, 0x0800, 2);
+      put(header, 0, 2);
+      put(header, dosTime, 2);
+      put(header, dosDate, 2);
+      put(header, entry.crc, 4);
+      put(header, entry.size, 4);
+      put(header, entry.size, 4);
+      put(header, entry.name.size(), 2);
+      put(header, zip64 ? 12 : 0, 2); // extra field
+      put(header, 0, 2);              // comment
+      put(header, 0, 2);              // disk
+      put(header, 0, 2);              // internal attributes
+      put(header, 0100644u << 16, 4); // external attributes (-rw-r--r--)
+      put(header, zip64 ? maxField : entry.offset, 4);
+      header += entry.name;
+      if (zip64) {
+        put(header, 0x0001, 2);
+        put(header, 8, 2);
+        put(header, entry.offset, 8);
+      }
+      file.write(header);
+    }
+
+    const std::uint64_t directoryEnd = file.offset();
+    const std::uint64_t directorySize = directoryEnd - directoryOffset;
+    std::string trailer;
+    if (entries.size() >= 0xFFFF || directoryOffset >= maxField ||
+        directorySize >= maxField) {
+      put(trailer, 0x06064b50, 4); // zip64 end of central directory
+      put(trailer, 44, 8);
+      put(trailer, (3 << 8) | 45, 2);
+      put(trailer, 45, 2);
+      put(trailer, 0, 4);
+      put(trailer, 0, 4);
+      put(trailer, entries.size(), 8);
+      put(trailer, entries.size(), 8);
+      put(trailer, directorySize, 8);
+      put(trailer, directoryOffset, 8);
+      put(trailer, 0x07064b50, 4); // zip64 locator
+      put(trailer, 0, 4);
+      put(trailer, directoryEnd, 8);
+      put(trailer, 1, 4);
+    }
+    put(trailer, 0x06054b50, 4); // end of central directory
+    put(trailer, 0, 2);
+    put(trailer, 0, 2);
+    put(trailer, std::min<std::uint64_t>(entries.size(), 0xFFFF), 2);
+    put(trailer, std::min<std::uint64_t>(entries.size(), 0xFFFF), 2);
+    put(trailer, std::min<std::uint64_t>(directorySize, maxField), 4);
+    put(trailer, std::min<std::uint64_t>(directoryOffset, maxField), 4);
+    put(trailer, 0, 2);
+    file.write(trailer);
+    file.close();
+  }
+};
+
+/**
+ * @brief Opens the output for a path: an archive for .tar, .tar.gz, .tgz and
+ * .zip, a directory otherwise.
+ * @param path Output path from the config.
+ * @param ioUring Write a directory with io_uring where supported.
+ * @return Output.
+ */
+std::unique_ptr<SiteOutput> openOutput(const fs::path &path,
+                                       bool ioUring = true) {
+  const std::string name = path.filename().string();
+  const bool tar = name.ends_with(".tar");
+  const bool tarGzip = name.ends_with(".tar.gz") || name.ends_with(".tgz");
+  const bool zip = name.ends_with(".zip");
+  if (!tar && !tarGzip && !zip)
+    return std::make_unique<DirectoryOutput>(path, ioUring);
+
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path());
+  if (zip)
+    return std::make_unique<ZipOutput>(path);
+  return std::make_unique<TarOutput>(path, tarGzip);
+}
+
+// --- NEW: Copy Assets ---
+
+/**
+ * @brief Copies the 'assets' folder from the template directory to the output.
+ * @param templatePath Path to the template file.
+ * @param output Site output.
+ * @param log Log.
+ * @return Copied files relative to the site root.
+ */
+std::vector<std::string> copyAssets(const fs::path &templatePath,
+                                    SiteOutput &output, Logger &log) {
+  // The folder where the template is located (e.g. "my_theme/")
+  fs::path templateDir = templatePath.parent_path();
+
+  // The expected assets folder (e.g. "my_theme/assets")
+  fs::path sourceAssets = templateDir / "assets";
+
+  std::vector<std::string> copied;
+  if (fs::exists(sourceAssets) && fs::is_directory(sourceAssets)) {
+    log.info("Found assets folder: " + sourceAssets.string());
+
+    try {
+      // Target: "assets/..." in the output
+      for (const auto &entry : fs::recursive_directory_iterator(sourceAssets)) {
+        if (!entry.is_regular_file())
+          continue;
+        const fs::path target =
+            "assets" / entry.path().lexically_relative(sourceAssets);
+        output.copyFile(target, entry.path());
+        copied.push_back(target.generic_string());
+      }
+
+      log.info(std::format("Assets successfully copied: {} files",
+                           copied.size()));
+    } catch (const fs::filesystem_error &e) {
+      log.error(std::format("Copying assets failed: {}", e.what()));
+    }
+  } else {
+    log.info("No assets folder found at: " + sourceAssets.string() +
+             " (skipping copy)");
+  }
+  return copied;
+}
+
+// --- Front Matter ---
+
+/**
+ * @brief Front matter of a Markdown file, as views into the file content.
+ */
+struct FrontMatter {
+  /// Header fields (KEY: value) in file order.
+  std::vector<std::pair<std::string_view, std::string_view>> fields;
+  std::string_view body; ///< Markdown after the header.
+};
+
+/**
+ * @brief Removes leading and trailing whitespace.
+ * @param text Text.
+ * @return Trimmed view of the text.
+ */
+std::string_view trimView(std::string_view text) {
+  auto isSpace = [](char ch) {
+    return std::isspace(static_cast<unsigned char>(ch));
+  };
+  while (!text.empty() && isSpace(text.front()))
+    text.remove_prefix(1);
+  while (!text.empty() && isSpace(text.back()))
+    text.remove_suffix(1);
+  return text;
+}
+
+/**
+ * @brief Splits the YAML-like header between '---' lines off a Markdown file.
+ *
+ * Same format as parse_front_matter in main.cpp (KEY: value lines), but the
+ * fields and the body are slices of the input, nothing is copied. A doctoc
+ * block in front of the header (as in docs/) is skipped, ssg5 generates its
+ * own table of contents.
+ *
+ * @param text Markdown content, must outlive the result.
+ * @return Header fields and body; without a header the body is the input.
+ */
+FrontMatter parseFrontMatter(std::string_view text) {
+  FrontMatter result;
+  result.body = text;
+
+  std::string_view rest = text;
+  auto skipSpace = [&]() {
+    rest.remove_prefix(
+        std::min(rest.find_first_not_of(" \t\r\n\f\v"), rest.size()));
+  };
+  skipSpace();
+  if (rest.starts_with("<!-- START doctoc")) {
+    const size_t tocEnd = rest.find("<!-- END doctoc");
+    const size_t commentEnd =
+        tocEnd == std::string_view::npos ? tocEnd : rest.find("-->", tocEnd);
+    if (commentEnd == std::string_view::npos)
+      return result;
+    rest.remove_prefix(commentEnd + 3);
+    skipSpace();
+  }
+  if (!rest.starts_with("---"))
+    return result; // no header
+  rest.remove_prefix(3);
+  if (rest.starts_with("\r\n"))
+    rest.remove_prefix(2);
+  else if (rest.starts_with('\n'))
+    rest.remove_prefix(1);
+
+  const size_t end = rest.find("\n---");
+  if (end == std::string_view::npos)
+    return result;
+  std::string_view header = rest.substr(0, end);
+
+  // Body starts after the line of the closing '---'
+  const size_t bodyStart = rest.find('\n', end + 4);
+  result.body = bodyStart == std::string_view::npos
+                    ? std::string_view()
+                    : rest.substr(bodyStart + 1);
+
+  while (!header.empty()) {
+    const size_t lineEnd = header.find('\n');
+    const std::string_view line = trimView(header.substr(0, lineEnd));
+    header.remove_prefix(lineEnd == std::string_view::npos ? header.size()
+                                                           : lineEnd + 1);
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos)
+      continue;
+    result.fields.emplace_back(trimView(line.substr(0, colon)),
+                               trimView(line.substr(colon + 1)));
+  }
+  return result;
+}
+
+// --- Markdown Logic ---
+
+/**
+ * @brief Result of rendering the Markdown of a page.
+ */
+struct MarkdownPage {
+  std::string html; ///< Rendered HTML.
+  json toc = json::array(); ///< Headings (level, id, title) in document order.
+  std::vector<std::string> brokenLinks; ///< Links to unknown Markdown files.
+  std::unordered_map<std::string, uint32_t> terms; ///< Word counts (search).
+};
+
+/**
+ * @brief Appends text with the HTML special characters escaped.
+ * @param out Output string.
+ * @param text Raw text.
+ */
+void appendEscaped(std::string &out, std::string_view text) {
+  size_t begin = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char *entity = nullptr;
+    switch (text[i]) {
+    case '&':
+      entity = "&amp;";
+      break;
+    case '<':
+      entity = "&lt;";
+      break;
+    case '>':
+      entity = "&gt;";
+      break;
+    case '"':
+      entity = "&quot;";
+      break;
+    default:
+      continue;
+    }
+    out.append(text.substr(begin, i - begin));
+    out.append(entity);
+    begin = i + 1;
+  }
+  out.append(text.substr(begin));
+}
+
+/**
+ * @brief Appends a URL, percent-encoding characters not allowed in it.
+ * @param out Output string.
+ * @param url Raw URL.
+ */
+void appendUrlEscaped(std::string &out, std::string_view url) {
+  static constexpr std::string_view allowed = "-_.+!*(),%#@?=;:/$~";
+  for (char ch : url) {
+    const auto byte = static_cast<unsigned char>(ch);
+    if (ch == '&')
+      out += "&amp;";
+    else if (std::isalnum(byte) || allowed.find(ch) != std::string_view::npos)
+      out += ch;
+    else
+      out += std::format("%{:02X}", byte);
+  }
+}
+
+/**
+ * @brief Decodes an HTML entity to UTF-8.
+ *
+ * Decodes numeric entities, the XML entities and the Latin-1 entities
+ * ("&eacute;", "&uuml;", ...). Heading ids are derived from the decoded text.
+ *
+ * @param out Output string.
+ * @param entity Entity including '&' and ';', e.g. "&amp;" or "&#x41;".
+ * @return False if the entity is unknown (nothing is appended).
+ */
+bool appendDecodedEntity(std::string &out, std::string_view entity) {
+  static constexpr std::array<std::string_view, 96> latin1 = {
+      "nbsp",   "iexcl",  "cent",   "pound",  "curren", "yen",    "brvbar",
+      "sect",   "uml",    "copy",   "ordf",   "laquo",  "not",    "shy",
+      "reg",    "macr",   "deg",    "plusmn", "sup2",   "sup3",   "acute",
+      "micro",  "para",   "middot", "cedil",  "sup1",   "ordm",   "raquo",
+      "frac14", "frac12", "frac34", "iquest", "Agrave", "Aacute", "Acirc",
+      "Atilde", "Auml",   "Aring",  "AElig",  "Ccedil", "Egrave", "Eacute",
+      "Ecirc",  "Euml",   "Igrave", "Iacute", "Icirc",  "Iuml",   "ETH",
+      "Ntilde", "Ograve", "Oacute", "Ocirc",  "Otilde", "Ouml",   "times",
+      "Oslash", "Ugrave", "Uacute", "Ucirc",  "Uuml",   "Yacute", "THORN",
+      "szlig",  "agrave", "aacute", "acirc",  "atilde", "auml",   "aring",
+      "aelig",  "ccedil", "egrave", "eacute", "ecirc",  "euml",   "igrave",
+      "iacute", "icirc",  "iuml",   "eth",    "ntilde", "ograve", "oacute",
+      "ocirc",  "otilde", "ouml",   "divide", "oslash", "ugrave", "uacute",
+      "ucirc",  "uuml",   "yacute", "thorn",  "yuml"};
+  static const std::unordered_map<std::string_view, char32_t> named = [] {
+    std::unordered_map<std::string_view, char32_t> map = {
+        {"amp", U'&'},      {"lt", U'<'},       {"gt", U'>'},
+        {"quot", U'"'},     {"apos", U'\''},    {"ndash", U'\u2013'},
+        {"mdash", U'\u2014'}, {"lsquo", U'\u2018'}, {"rsquo", U'\u2019'},
+        {"ldquo", U'\u201C'}, {"rdquo", U'\u201D'}, {"bull", U'\u2022'},
+        {"hellip", U'\u2026'}, {"euro", U'\u20AC'}, {"trade", U'\u2122'}};
+    for (size_t i = 0; i < latin1.size(); ++i)
+      map.emplace(latin1[i], static_cast<char32_t>(0xA0 + i));
+    return map;
+  }();
+
+  if (entity.size() < 3 || entity.front() != '&' || entity.back() != ';')
+    return false;
+  std::string_view name = entity.substr(1, entity.size() - 2);
+  char32_t codepoint = 0;
+  if (name.front() == '#') {
+    name.remove_prefix(1);
+    const int base = !name.empty() && (name.front() == 'x' || name.front() == 'X') ? 16 : 10;
+    if (base == 16)
+      name.remove_prefix(1);
+    uint32_t value = 0;
+    const auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), value, base);
+    if (ec != std::errc() || end != name.data() + name.size())
+      return false;
+    // Like md4c-html, invalid code points become U+FFFD
+    codepoint = (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) ? U'\uFFFD' : value;
+  } else if (const auto it = named.find(name); it != named.end()) {
+    codepoint = it->second;
+  } else {
+    return false;
+  }
+
+  if (codepoint < 0x80) {
+    out += static_cast<char>(codepoint);
+  } else if (codepoint < 0x800) {
+    out += static_cast<char>(0xC0 | (codepoint >> 6));
+    out += static_cast<char>(0x80 | (codepoint & 0x3F));
+  } else if (codepoint < 0x10000) {
+    out += static_cast<char>(0xE0 | (codepoint >> 12));
+    out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codepoint & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (codepoint >> 18));
+    out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codepoint & 0x3F));
+  }
+  return true;
+}
+
+/**
+ * @brief Splits text into search terms and counts them.
+ *
+ * Terms are runs of ASCII letters, digits, '_' and non-ASCII (UTF-8) bytes
+ * of at least two bytes, ASCII letters in lower case. search.js splits
+ * queries the same way.
+ *
+ * @param text Text.
+ * @param terms Term counts.
+ */
+void addSearchTerms(std::string_view text,
+                    std::unordered_map<std::string, uint32_t> &terms) {
+  constexpr size_t maxTermLength = 32;
+  std::string term;
+  auto flush = [&]() {
+    if (term.size() >= 2 && term.size() <= maxTermLength)
+      ++terms[term];
+    term.clear();
+  };
+  for (char ch : text) {
+    const auto byte = static_cast<unsigned char>(ch);
+    if (std::isalnum(byte) || ch == '_' || byte >= 0x80)
+      term += static_cast<char>(std::tolower(byte));
+    else
+      flush();
+  }
+  flush();
+}
+
+/**
+ * @brief HTML renderer for md4c with heading ids and table of contents.
+ *
+ * Produces the same HTML as md4c-html, but gives every heading a stable id
+ * (GitHub style, e.g. "Getting Started" -> "getting-started") and records it
+ * in the table of contents while the document is parsed. Relative links to
+ * other Markdown pages are rewritten to their HTML output. There is no second
+ * pass over the Markdown or the HTML; md4c-html has no hooks for either, so
+ * the renderer follows it event by event (tests/test_ssg5_markdown.cpp
+ * compares both on the repository's Markdown files).
+ */
+class HtmlRenderer {
+  const NavTree &tree; ///< Known pages, to resolve links between pages.
+  fs::path pageDir;    ///< Folder of the page, relative to the site root.
+  MarkdownPage page;
+  std::unordered_map<std::string, int> headingIds; ///< Id -> times used.
+  size_t headingStart = 0;   ///< Output position of the open heading.
+  std::string headingText;   ///< Plain text of the open heading (for the id).
+  std::string headingTitle;  ///< HTML of the open heading (for the TOC).
+  bool inHeading = false;    ///< Inside a heading.
+  bool collectTerms = false; ///< Count the words for the search index.
+  int imageNesting = 0;      ///< Inside an image (alt text is plain text).
+
+  /// Renders an attribute, its entities are kept verbatim.
+  template <class Escape>
+  void appendAttribute(const MD_ATTRIBUTE &attr, Escape escape) {
+    for (size_t i = 0; attr.substr_offsets[i] < attr.size; ++i) {
+      std::string_view text(attr.text + attr.substr_offsets[i],
+                            attr.substr_offsets[i + 1] - attr.substr_offsets[i]);
+      switch (attr.substr_types[i]) {
+      case MD_TEXT_NULLCHAR:
+        page.html += "\xEF\xBF\xBD";
+        break;
+      case MD_TEXT_ENTITY:
+        page.html += text;
+        break;
+      default:
+        escape(page.html, text);
+      }
+    }
+  }
+
+  /**
+   * @brief Rewrites a relative link to a Markdown page to the page's HTML.
+   * @param href Raw link target, e.g. "../fold3/section.md#usage".
+   * @param target Rewritten link target.
+   * @return False if the link is not a relative link to a Markdown file.
+   */
+  bool rewritePageLink(std::string_view href, std::string &target) {
+    const size_t pathEnd = href.find_first_of("?#");
+    const std::string_view path = href.substr(0, pathEnd);
+    // Absolute paths and URLs with a scheme ("https:", "mailto:") stay as is
+    if (path.empty() || path.front() == '/' ||
+        path.find(':') != std::string_view::npos ||
+        !path.ends_with(".md"))
+      return false;
+
+    fs::path linkPath(path);
+    const std::string resolved =
+        fs::path(pageDir / linkPath)
+            .lexically_normal()
+            .replace_extension(".html")
+            .generic_string();
+    if (!tree.pageIndex.contains(resolved)) {
+      page.brokenLinks.emplace_back(href);
+      return false;
+    }
+    target = linkPath.replace_extension(".html").generic_string();
+    if (pathEnd != std::string_view::npos)
+      target += href.substr(pathEnd);
+    return true;
+  }
+
+  /// Derives a unique id from the heading text.
+  std::string makeHeadingId(std::string_view text) {
+    std::string id;
+    for (char ch : text) {
+      const auto byte = static_cast<unsigned char>(ch);
+      if (std::isalnum(byte) || byte >= 0x80 || ch == '_' || ch == '-')
+        id += static_cast<char>(std::tolower(byte));
+      else if (ch == ' ')
+        id += '-';
+    }
+    if (id.empty())
+      id = "section";
+
+    // Repeated headings get a suffix: "usage", "usage-1", "usage-2", ...
+    int &used = headingIds[id];
+    std::string unique = used ? std::format("{}-{}", id, used) : id;
+    ++used;
+    return unique;
+  }
+
+  void enterBlock(MD_BLOCKTYPE type, void *detail) {
+    switch (type) {
+    case MD_BLOCK_QUOTE:
+      page.html += "<blockquote>\n";
+      break;
+    case MD_BLOCK_UL:
+      page.html += "<ul>\n";
+      break;
+    case MD_BLOCK_OL: {
+      const unsigned start = static_cast<MD_BLOCK_OL_DETAIL *>(detail)->start;
+      page.html += start == 1 ? std::string("<ol>\n")
+                              : std::format("<ol start=\"{}\">\n", start);
+      break;
+    }
+    case MD_BLOCK_LI: {
+      const auto *li = static_cast<MD_BLOCK_LI_DETAIL *>(detail);
+      if (li->is_task) {
+        page.html += "<li class=\"task-list-item\">"
+                     "<input type=\"checkbox\" class=\"task-list-item-checkbox\""
+                     " disabled";
+        if (li->task_mark == 'x' || li->task_mark == 'X')
+          page.html += " checked";
+        page.html += ">";
+      } else {
+        page.html += "<li>";
+      }
+      break;
+    }
+    case MD_BLOCK_HR:
+      page.html += "<hr>\n";
+      break;
+    case MD_BLOCK_H:
+      // The opening tag is inserted when the id is known
+      inHeading = true;
+      headingStart = page.html.size();
+      headingText.clear();
+      headingTitle.clear();
+      break;
+    case MD_BLOCK_CODE: {
+      const auto *code = static_cast<MD_BLOCK_CODE_DETAIL *>(detail);
+      page.html += "<pre><code";
+      if (code->lang.text != nullptr) {
+        page.html += " class=\"language-";
+        appendAttribute(code->lang, appendEscaped);
+        page.html += "\"";
+      }
+      page.html += ">";
+      break;
+    }
+    case MD_BLOCK_P:
+      page.html += "<p>";
+      break;
+    case MD_BLOCK_TABLE:
+      page.html += "<table>\n";
+      break;
+    case MD_BLOCK_THEAD:
+      page.html += "<thead>\n";
+      break;
+    case MD_BLOCK_TBODY:
+      page.html += "<tbody>\n";
+      break;
+    case MD_BLOCK_TR:
+      page.html += "<tr>\n";
+      break;
+    case MD_BLOCK_TH:
+    case MD_BLOCK_TD: {
+      page.html += type == MD_BLOCK_TH ? "<th" : "<td";
+      switch (static_cast<MD_BLOCK_TD_DETAIL *>(detail)->align) {
+      case MD_ALIGN_LEFT:
+        page.html += " align=\"left\"";
+        break;
+      case MD_ALIGN_CENTER:
+        page.html += " align=\"center\"";
+        break;
+      case MD_ALIGN_RIGHT:
+        page.html += " align=\"right\"";
+        break;
+      default:
+        break;
+      }
+      page.html += ">";
+      break;
+    }
+    default: // MD_BLOCK_DOC, MD_BLOCK_HTML
+      break;
+    }
+  }
+
+  void leaveBlock(MD_BLOCKTYPE type, void *detail) {
+    switch (type) {
+    case MD_BLOCK_QUOTE:
+      page.html += "</blockquote>\n";
+      break;
+    case MD_BLOCK_UL:
+      page.html += "</ul>\n";
+      break;
+    case MD_BLOCK_OL:
+      page.html += "</ol>\n";
+      break;
+    case MD_BLOCK_LI:
+      page.html += "</li>\n";
+      break;
+    case MD_BLOCK_H: {
+      const unsigned level = static_cast<MD_BLOCK_H_DETAIL *>(detail)->level;
+      std::string id = makeHeadingId(headingText);
+      page.html.insert(headingStart,
+                       std::format("<h{} id=\"{}\">", level, id));
+      page.html += std::format("</h{}>\n", level);
+
+      page.toc.push_back({{"level", level},
+                          {"id", std::move(id)},
+                          {"title", std::move(headingTitle)}});
+      inHeading = false;
+      break;
+    }
+    case MD_BLOCK_CODE:
+      page.html += "</code></pre>\n";
+      break;
+    case MD_BLOCK_P:
+      page.html += "</p>\n";
+      break;
+    case MD_BLOCK_TABLE:
+      page.html += "</table>\n";
+      break;
+    case MD_BLOCK_THEAD:
+      page.html += "</thead>\n";
+      break;
+    case MD_BLOCK_TBODY:
+      page.html += "</tbody>\n";
+      break;
+    case MD_BLOCK_TR:
+      page.html += "</tr>\n";
+      break;
+    case MD_BLOCK_TH:
+      page.html += "</th>\n";
+      break;
+    case MD_BLOCK_TD:
+      page.html += "</td>\n";
+      break;
+    default:
+      break;
+    }
+  }
+
+  void enterSpan(MD_SPANTYPE type, void *detail) {
+    if (imageNesting > 0) {
+      // Nested images only contribute their alt text
+      if (type == MD_SPAN_IMG)
+        ++imageNesting;
+      return;
+    }
+    switch (type) {
+    case MD_SPAN_EM:
+      page.html += "<em>";
+      break;
+    case MD_SPAN_STRONG:
+      page.html += "<strong>";
+      break;
+    case MD_SPAN_U:
+      page.html += "<u>";
+      break;
+    case MD_SPAN_A: {
+      const auto *a = static_cast<MD_SPAN_A_DETAIL *>(detail);
+      page.html += "<a href=\"";
+      std::string target;
+      if (!a->is_autolink &&
+          rewritePageLink({a->href.text, a->href.size}, target))
+        appendUrlEscaped(page.html, target);
+      else
+        appendAttribute(a->href, appendUrlEscaped);
+      page.html += "\"";
+      if (a->title.text != nullptr) {
+        page.html += " title=\"";
+        appendAttribute(a->title, appendEscaped);
+        page.html += "\"";
+      }
+      page.html += ">";
+      break;
+    }
+    case MD_SPAN_IMG: {
+      const auto *img = static_cast<MD_SPAN_IMG_DETAIL *>(detail);
+      page.html += "<img src=\"";
+      appendAttribute(img->src, appendUrlEscaped);
+      page.html += "\" alt=\"";
+      ++imageNesting;
+      break;
+    }
+    case MD_SPAN_CODE:
+      page.html += "<code>";
+      break;
+    case MD_SPAN_DEL:
+      page.html += "<del>";
+      break;
+    case MD_SPAN_LATEXMATH:
+      page.html += "<x-equation>";
+      break;
+    case MD_SPAN_LATEXMATH_DISPLAY:
+      page.html += "<x-equation type=\"display\">";
+      break;
+    case MD_SPAN_WIKILINK:
+      page.html += "<x-wikilink data-target=\"";
+      appendAttribute(static_cast<MD_SPAN_WIKILINK_DETAIL *>(detail)->target,
+                      appendEscaped);
+      page.html += "\">";
+      break;
+    }
+  }
+
+  void leaveSpan(MD_SPANTYPE type, void *detail) {
+    if (imageNesting > 0) {
+      if (type == MD_SPAN_IMG && --imageNesting == 0) {
+        const auto *img = static_cast<MD_SPAN_IMG_DETAIL *>(detail);
+        page.html += "\"";
+        if (img->title.text != nullptr) {
+          page.html += " title=\"";
+          appendAttribute(img->title, appendEscaped);
+          page.html += "\"";
+        }
+        page.html += ">";
+      }
+      return;
+    }
+    switch (type) {
+    case MD_SPAN_EM:
+      page.html += "</em>";
+      break;
+    case MD_SPAN_STRONG:
+      page.html += "</strong>";
+      break;
+    case MD_SPAN_U:
+      page.html += "</u>";
+      break;
+    case MD_SPAN_A:
+      page.html += "</a>";
+      break;
+    case MD_SPAN_CODE:
+      page.html += "</code>";
+      break;
+    case MD_SPAN_DEL:
+      page.html += "</del>";
+      break;
+    case MD_SPAN_LATEXMATH:
+    case MD_SPAN_LATEXMATH_DISPLAY:
+      page.html += "</x-equation>";
+      break;
+    case MD_SPAN_WIKILINK:
+      page.html += "</x-wikilink>";
+      break;
+    default:
+      break;
+    }
+  }
+
+  void text(MD_TEXTTYPE type, std::string_view text) {
+    if (inHeading) {
+      if (type == MD_TEXT_NORMAL || type == MD_TEXT_CODE) {
+        headingText += text;
+        appendEscaped(headingTitle, text);
+      } else if (type == MD_TEXT_ENTITY) {
+        // The id uses the decoded text, the title keeps the entity like the page
+        appendDecodedEntity(headingText, text);
+        if (headingText.ends_with("\xC2\xA0")) // &nbsp; separates words
+          headingText.replace(headingText.size() - 2, 2, " ");
+        headingTitle += text;
+      }
+    }
+    if (collectTerms && (type == MD_TEXT_NORMAL || type == MD_TEXT_CODE))
+      addSearchTerms(text, page.terms);
+
+    switch (type) {
+    case MD_TEXT_NULLCHAR:
+      page.html += "\xEF\xBF\xBD";
+      break;
+    case MD_TEXT_BR:
+      page.html += imageNesting > 0 ? " " : "<br>\n";
+      break;
+    case MD_TEXT_SOFTBR:
+      page.html += imageNesting > 0 ? " " : "\n";
+      if (inHeading) {
+        headingText += ' ';
+        headingTitle += ' ';
+      }
+      break;
+    case MD_TEXT_HTML:
+      page.html += text;
+      break;
+    case MD_TEXT_ENTITY:
+      // Browsers decode entities, they are kept verbatim
+      page.html += text;
+      break;
+    default:
+      appendEscaped(page.html, text);
+    }
+  }
+
+public:
+  /**
+   * @param tree Navigation tree with the pages of the site.
+   * @param activePath Output file of the page, relative to the site root.
+   * @param collectTerms Count the words of the page for the search index.
+   */
+  HtmlRenderer(const NavTree &tree, const std::string &activePath,
+               bool collectTerms)
+      : tree(tree), pageDir(fs::path(activePath).parent_path()),
+        collectTerms(collectTerms) {}
+
+  /**
+   * @brief Renders a Markdown document.
+   * @param mdContent Markdown string.
+   * @return HTML and table of contents.
+   */
+  MarkdownPage render(std::string_view mdContent) {
+    static const MD_PARSER parser = {
+        0,
+        MD_DIALECT_GITHUB,
+        [](MD_BLOCKTYPE type, void *detail, void *self) {
+          static_cast<HtmlRenderer *>(self)->enterBlock(type, detail);
+          return 0;
+        },
+        [](MD_BLOCKTYPE type, void *detail, void *self) {
+          static_cast<HtmlRenderer *>(self)->leaveBlock(type, detail);
+          return 0;
+        },
+        [](MD_SPANTYPE type, void *detail, void *self) {
+          static_cast<HtmlRenderer *>(self)->enterSpan(type, detail);
+          return 0;
+        },
+        [](MD_SPANTYPE type, void *detail, void *self) {
+          static_cast<HtmlRenderer *>(self)->leaveSpan(type, detail);
+          return 0;
+        },
+        [](MD_TEXTTYPE type, const MD_CHAR *text, MD_SIZE size, void *self) {
+          static_cast<HtmlRenderer *>(self)->text(type, {text, size});
+          return 0;
+        },
+        nullptr,
+        nullptr};
+
+    page.html.reserve(mdContent.size() + mdContent.size() / 4);
+    int ret = md_parse(mdContent.data(), static_cast<MD_SIZE>(mdContent.size()),
+                       &parser, this);
+    if (ret != 0)
+      throw std::runtime_error("Markdown parsing failed.");
+    return std::move(page);
+  }
+};
+
+/**
+ * @brief Renders Markdown to HTML.
+ * @param mdContent Markdown string.
+ * @param tree Navigation tree with the pages of the site.
+ * @param activePath Output file of the page, relative to the site root.
+ * @param collectTerms Count the words of the page for the search index.
+ * @return HTML, table of contents, broken links and word counts.
+ */
+MarkdownPage renderMarkdown(std::string_view mdContent, const NavTree &tree,
+                            const std::string &activePath,
+                            bool collectTerms = false) {
+  return HtmlRenderer(tree, activePath, collectTerms).render(mdContent);
+}
+
+/**
+ * @brief Parses the configuration file.
+ * @param configPath Path to config file.
+ * @return Config object.
+ */
+Config parseConfig(const fs::path &configPath) {
+  Config cfg;
+  std::ifstream file(configPath);
+  if (!file)
+    throw std::runtime_error("Configuration file not found.");
+  std::string line;
+  while (std::getline(file, line)) {
+    auto delimiterPos = line.find('=');
+    if (delimiterPos != std::string::npos) {
+      std::string key = line.substr(0, delimiterPos);
+      std::string value = line.substr(delimiterPos + 1);
+
+      if (key == "template")
+        cfg.templatePath = value;
+      else if (key == "output")
+        cfg.outputDir = value;
+      else if (key == "threads")
+        cfg.threads = static_cast<unsigned>(std::stoul(value));
+      else if (key == "template_cache")
+        cfg.templateCacheDir = value;
+      else if (key == "nav_scope")
+        cfg.scopedNav = (value == "scoped");
+      else if (key == "taxonomies")
+        cfg.taxonomies = (value == "on" || value == "true");
+      else if (key == "listing_page_size")
+        cfg.listingPageSize = std::stoul(value);
+      else if (key == "site_url") {
+        cfg.siteUrl = value;
+        while (cfg.siteUrl.ends_with('/'))
+          cfg.siteUrl.pop_back();
+      } else if (key == "site_title")
+        cfg.siteTitle = value;
+      else if (key == "sitemap_gzip")
+        cfg.sitemapGzip = (value == "on" || value == "true");
+      else if (key == "feed_size")
+        cfg.feedSize = std::stoul(value);
+      else if (key == "search")
+        cfg.searchIndex = (value == "on" || value == "true");
+      else if (key == "io_uring")
+        cfg.ioUring = !(value == "off" || value == "false");
+    }
+  }
+  return cfg;
+}
+
+// --- Logic: Build Tree (MD only) ---
+
+/**
+ * @brief Builds the directory tree, filtering for .md files.
+ * @param currentPath Current scanning path.
+ * @param rootPath Root input path.
+ * @return DirNode structure.
+ */
+DirNode buildTree(const fs::path &currentPath, const fs::path &rootPath) {
+  DirNode node;
+  node.dirName = currentPath.filename().string();
+  node.relativePath = fs::relative(currentPath, rootPath);
+  if (node.relativePath == ".")
+    node.relativePath = "";
+
+  for (const auto &entry : fs::directory_iterator(currentPath)) {
+    if (entry.is_directory()) {
+      node.subdirs.push_back(buildTree(entry.path(), rootPath));
+    } else if (entry.is_regular_file()) {
+      if (entry.path().extension() == ".md") {
+        node.files.push_back(entry.path().filename());
+      }
+    }
+  }
+  std::ranges::sort(node.subdirs, {}, &DirNode::dirName);
+  std::ranges::sort(node.files);
+  return node;
+}
+
+// --- Header Pre-Scan ---
+
+/// Bytes read from the start of a file to find its front matter.
+constexpr size_t headerPrefixSize = 4096;
+
+/**
+ * @brief Reads at most the first bytes of a file.
+ * @param path Path to the file.
+ * @param limit Maximum number of bytes.
+ * @return File prefix.
+ */
+std::string readFilePrefix(const fs::path &path, size_t limit) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error(
+        std::format("Could not read file: {}", path.string()));
+  std::string prefix(limit, '\0');
+  size_t size = 0;
+  while (size < limit) {
+    const ssize_t n = ::pread(fd, prefix.data() + size, limit - size,
+                              static_cast<off_t>(size));
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      break;
+    size += static_cast<size_t>(n);
+  }
+  ::close(fd);
+  prefix.resize(size);
+  return prefix;
+}
+
+/**
+ * @brief Compares a header key case-insensitively.
+ * @param key Key of the file.
+ * @param name Upper case name.
+ * @return True if the key matches.
+ */
+bool isHeaderKey(std::string_view key, std::string_view name) {
+  return std::ranges::equal(key, name, [](char a, char b) {
+    return std::toupper(static_cast<unsigned char>(a)) == b;
+  });
+}
+
+/**
+ * @brief Reads the front matter of a page from the start of its file.
+ *
+ * Only a bounded prefix is read; the whole file is only read if its header
+ * does not fit into the prefix.
+ *
+ * @param path Path to the Markdown file.
+ * @return Page header.
+ */
+PageHeader scanPageHeader(const fs::path &path) {
+  std::string text = readFilePrefix(path, headerPrefixSize);
+  FrontMatter frontMatter = parseFrontMatter(text);
+  const std::string_view start = trimView(text);
+  if (text.size() == headerPrefixSize && frontMatter.fields.empty() &&
+      (start.starts_with("---") || start.starts_with("<!-- START doctoc"))) {
+    text = readFile(path);
+    frontMatter = parseFrontMatter(text);
+  }
+
+  PageHeader header;
+  for (const auto &[key, value] : frontMatter.fields) {
+    header.meta[std::string(key)] = value;
+    if (isHeaderKey(key, "TITLE")) {
+      header.title = value;
+    } else if (isHeaderKey(key, "DRAFT")) {
+      header.draft = isHeaderKey(value, "TRUE") || isHeaderKey(value, "YES") ||
+                     value == "1";
+    } else if (isHeaderKey(key, "ORDER")) {
+      std::from_chars(value.data(), value.data() + value.size(), header.order);
+    }
+  }
+  return header;
+}
+
+/**
+ * @brief Reads the headers of all pages, drops drafts and orders the pages.
+ *
+ * The headers are read in parallel. Pages of a folder are sorted by their
+ * ORDER field, pages without it follow in file name order, so the navigation
+ * is known before any page is loaded completely.
+ *
+ * @param rootNode Root node of the tree.
+ * @param inputRoot Input root.
+ * @param threadCount Number of threads (0 = hardware concurrency).
+ */
+void prescanHeaders(DirNode &rootNode, const fs::path &inputRoot,
+                    unsigned threadCount) {
+  std::vector<DirNode *> nodes;
+  std::vector<std::pair<DirNode *, size_t>> files;
+  auto collect = [&](auto &self, DirNode &node) -> void {
+    nodes.push_back(&node);
+    node.headers.resize(node.files.size());
+    for (size_t i = 0; i < node.files.size(); ++i)
+      files.emplace_back(&node, i);
+    for (auto &sub : node.subdirs)
+      self(self, sub);
+  };
+  collect(collect, rootNode);
+
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  threadCount = static_cast<unsigned>(
+      std::clamp<size_t>(threadCount, 1, std::max<size_t>(files.size(), 1)));
+
+  std::atomic<size_t> nextFile{0};
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto worker = [&]() {
+    for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+      auto [node, index] = files[i];
+      try {
+        node->headers[index] = scanPageHeader(
+            inputRoot / node->relativePath / node->files[index]);
+      } catch (...) {
+        std::lock_guard lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> workers;
+    for (unsigned t = 1; t < threadCount; ++t)
+      workers.emplace_back(worker);
+    worker();
+  }
+  if (error)
+    std::rethrow_exception(error);
+
+  for (DirNode *node : nodes) {
+    std::vector<size_t> published;
+    for (size_t i = 0; i < node->files.size(); ++i) {
+      if (!node->headers[i].draft)
+        published.push_back(i);
+    }
+    std::ranges::stable_sort(published, {}, [&](size_t i) {
+      return node->headers[i].order;
+    });
+
+    std::vector<fs::path> files;
+    std::vector<PageHeader> headers;
+    for (size_t i : published) {
+      files.push_back(std::move(node->files[i]));
+      headers.push_back(std::move(node->headers[i]));
+    }
+    node->files = std::move(files);
+    node->headers = std::move(headers);
+  }
+}
+
+/**
+ * @brief Generates back references (../) for relative paths.
+ * @param currentRelPath Current relative path.
+ * @return String with "../" sequences.
+ */
+std::string getBackPrefix(const fs::path &currentRelPath) {
+  std::string prefix = "";
+  for (const auto &_ : currentRelPath) {
+    prefix += "../";
+  }
+  return prefix;
+}
+
+/**
+ * @brief Converts filename extension from .md to .html.
+ * @param sourceFile Source filename.
+ * @return Target filename.
+ */
+fs::path getTargetFilename(const fs::path &sourceFile) {
+  fs::path p = sourceFile;
+  if (p.extension() == ".md")
+    p.replace_extension(".html");
+  return p;
+}
+
+/**
+ * @brief Returns the title of a page.
+ * @param file Source filename.
+ * @param header Page header.
+ * @return TITLE of the header, otherwise the file name without extension.
+ */
+std::string pageTitle(const fs::path &file, const PageHeader &header) {
+  return header.title.empty() ? file.stem().string() : header.title;
+}
+
+// --- Navigation Model ---
+
+/**
+ * @brief Indexes the pages below a collapsed folder without nav entries.
+ *
+ * The navigation collapses a single-page folder into one link, so the pages
+ * of its sub folders have no node. They are still pages of the site.
+ *
+ * @param tree Navigation tree.
+ * @param currentNode Sub folder of a collapsed folder.
+ */
+void addHiddenPages(NavTree &tree, const DirNode &currentNode) {
+  for (const auto &file : currentNode.files)
+    tree.pageIndex.emplace(
+        (currentNode.relativePath / getTargetFilename(file)).generic_string(),
+        0);
+  for (const auto &sub : currentNode.subdirs)
+    addHiddenPages(tree, sub);
+}
+
+/**
+ * @brief Adds the entries of a directory to the navigation tree.
+ *
+ * Pages come first, then folders. A folder with a single page is collapsed
+ * into a link to that page, labeled with the folder name. Titles are stored
+ * HTML-escaped, like the titles of the table of contents.
+ *
+ * @param tree Navigation tree.
+ * @param currentNode Current node.
+ * @param folder Index of the folder node of currentNode.
+ * @param depth Nesting depth of the entries.
+ */
+void addNavEntries(NavTree &tree, const DirNode &currentNode, size_t folder,
+                   int depth) {
+  auto addNode = [&](std::string_view title, const fs::path &href,
+                     bool isFolder) {
+    const size_t index = tree.nodes.size();
+    NavTree::Node node;
+    // Titles come from file names and front matter, themes print them as is
+    appendEscaped(node.title, title);
+    node.href = href.generic_string();
+    node.depth = depth;
+    node.isFolder = isFolder;
+    node.parent = folder;
+    if (!isFolder) {
+      node.order = tree.pageOrder.size();
+      tree.pageOrder.push_back(index);
+      tree.pageIndex.emplace(node.href, index);
+    }
+    tree.nodes.push_back(std::move(node));
+    tree.nodes[folder].children.push_back(index);
+    return index;
+  };
+
+  for (size_t i = 0; i < currentNode.files.size(); ++i) {
+    const auto &file = currentNode.files[i];
+    addNode(pageTitle(file, currentNode.headers[i]),
+            currentNode.relativePath / getTargetFilename(file), false);
+  }
+  for (const auto &sub : currentNode.subdirs) {
+    if (sub.files.size() == 1) {
+      addNode(sub.dirName, sub.relativePath / getTargetFilename(sub.files[0]),
+              false);
+      for (const auto &hidden : sub.subdirs)
+        addHiddenPages(tree, hidden);
+    } else {
+      const size_t index = addNode(sub.dirName, sub.relativePath, true);
+      addNavEntries(tree, sub, index, depth + 1);
+    }
+  }
+}
+
+/**
+ * @brief Builds the navigation tree of the site.
+ * @param rootNode Root node.
+ * @return Navigation tree.
+ */
+NavTree buildNavTree(const DirNode &rootNode) {
+  NavTree tree;
+  tree.nodes.emplace_back(); // site root
+  addNavEntries(tree, rootNode, 0, 0);
+  return tree;
+}
+
+/**
+ * @brief Converts the entries of a folder into nav items.
+ * @param tree Navigation tree.
+ * @param folder Index of the folder.
+ * @param expand Returns whether the entries of a sub folder are included.
+ * @return Array of nav items (title, href, depth, is_folder, expanded,
+ * children).
+ */
+template <class Expand>
+json buildNavItems(const NavTree &tree, size_t folder, const Expand &expand) {
+  json items = json::array();
+  for (size_t index : tree.nodes[folder].children) {
+    const auto &node = tree.nodes[index];
+    const bool expanded = node.isFolder && expand(index);
+    items.push_back({{"title", node.title},
+                     {"href", node.href},
+                     {"depth", node.depth},
+                     {"is_folder", node.isFolder},
+                     {"expanded", expanded},
+                     {"children", expanded ? buildNavItems(tree, index, expand)
+                                           : json::array()}});
+  }
+  return items;
+}
+
+/**
+ * @brief Builds the complete navigation model, shared by all pages.
+ * @param tree Navigation tree.
+ * @return Array of nav items.
+ */
+json buildNavModel(const NavTree &tree) {
+  return buildNavItems(tree, 0, [](size_t) { return true; });
+}
+
+/**
+ * @brief Builds the scoped navigation model of a page.
+ *
+ * Contains the top-level entries, the ancestors of the page and their
+ * entries (the page's siblings). Only the folders on the path to the page are
+ * expanded, so the cost is O(depth x fan-out) independent of the site size.
+ *
+ * @param tree Navigation tree.
+ * @param pageNode Node of the page.
+ * @return Array of nav items.
+ */
+json buildScopedNavModel(const NavTree &tree, size_t pageNode) {
+  // Ancestor folders of the page, indexed by their depth
+  std::vector<size_t> ancestors;
+  for (size_t folder = tree.nodes[pageNode].parent; folder != 0;
+       folder = tree.nodes[folder].parent) {
+    ancestors.push_back(folder);
+  }
+  std::ranges::reverse(ancestors);
+
+  return buildNavItems(tree, 0, [&](size_t index) {
+    const auto depth = static_cast<size_t>(tree.nodes[index].depth);
+    return depth < ancestors.size() && ancestors[depth] == index;
+  });
+}
+
+/**
+ * @brief Converts a node into a link item.
+ * @param tree Navigation tree.
+ * @param index Index of the node.
+ * @return Link item (title, href, is_folder).
+ */
+json navLink(const NavTree &tree, size_t index) {
+  const auto &node = tree.nodes[index];
+  return {{"title", node.title},
+          {"href", node.href},
+          {"is_folder", node.isFolder}};
+}
+
+/**
+ * @brief Builds the breadcrumbs of a page by following the parent links.
+ * @param tree Navigation tree.
+ * @param pageNode Node of the page.
+ * @return Link items from the top-level folder down to the page itself.
+ */
+json buildBreadcrumbs(const NavTree &tree, size_t pageNode) {
+  json crumbs = json::array();
+  for (size_t index = pageNode; index != 0; index = tree.nodes[index].parent)
+    crumbs.push_back(navLink(tree, index));
+  std::reverse(crumbs.begin(), crumbs.end());
+  return crumbs;
+}
+
+/**
+ * @brief Returns the neighbour of a page in reading order.
+ * @param tree Navigation tree.
+ * @param pageNode Node of the page.
+ * @param offset -1 for the previous, +1 for the next page.
+ * @return Link item, null at the start or end of the site.
+ */
+json pageNeighbour(const NavTree &tree, size_t pageNode, int offset) {
+  const size_t order = tree.nodes[pageNode].order;
+  if ((offset < 0 && order == 0) ||
+      (offset > 0 && order + 1 >= tree.pageOrder.size()))
+    return nullptr;
+  return navLink(tree, tree.pageOrder[order + offset]);
+}
+
+// --- Navigation Generator ---
+
+/**
+ * @brief Generates Navigation HTML from the navigation model.
+ * @param items Nav items.
+ * @param html Output HTML string.
+ * @param urlPrefix URL prefix.
+ * @param activePath Active file for highlighting.
+ */
+void generateNavHtml(const json &items, std::string &html,
+                     const std::string &urlPrefix,
+                     const std::string &activePath) {
+
+  html += "<ul class=\"nav-list\">\n";
+
+  for (const auto &item : items) {
+    const auto &title = item["title"].get_ref<const std::string &>();
+    if (item["is_folder"].get<bool>()) {
+      html += std::format("  <li><strong>{}</strong>\n", title);
+      if (item["expanded"].get<bool>())
+        generateNavHtml(item["children"], html, urlPrefix, activePath);
+      html += "  </li>\n";
+    } else {
+      const auto &href = item["href"].get_ref<const std::string &>();
+      std::string classAttr = (href == activePath) ? " class=\"active\"" : "";
+
+      html += std::format("  <li><a href=\"{}{}\"{}>{}</a></li>\n", urlPrefix,
+                          href, classAttr, title);
+    }
+  }
+  html += "</ul>\n";
+}
+
+/**
+ * @brief Generates the navigation HTML of a page.
+ * @param site Site-wide state.
+ * @param page Page to render.
+ * @return Navigation HTML.
+ */
+std::string buildNavigation(const Site &site, const Page &page) {
+  std::string navHtml;
+  if (site.scopedNav)
+    generateNavHtml(buildScopedNavModel(site.navTree, page.navNode),
+                    navHtml, page.backPrefix, page.activePath);
+  else
+    generateNavHtml(site.globals["nav"], navHtml, page.backPrefix,
+                    page.activePath);
+  return navHtml;
+}
+
+// --- Link Checker ---
+
+/**
+ * @brief Hash set of strings that many threads can insert into at once.
+ *
+ * The set is split into shards by hash, each with its own lock, so threads
+ * rarely wait for each other.
+ */
+class ConcurrentStringSet {
+  static constexpr size_t shardCount = 64;
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_set<std::string> values;
+  };
+  std::array<Shard, shardCount> shards;
+
+  Shard &shardOf(const std::string &value) {
+    return shards[std::hash<std::string>{}(value) % shardCount];
+  }
+
+public:
+  void insert(std::string value) {
+    Shard &shard = shardOf(value);
+    std::lock_guard lock(shard.mutex);
+    shard.values.insert(std::move(value));
+  }
+
+  /// Not synchronized with insert(), call after all inserts are done.
+  bool contains(const std::string &value) const {
+    const Shard &shard = shards[std::hash<std::string>{}(value) % shardCount];
+    return shard.values.contains(value);
+  }
+};
+
+/**
+ * @brief Checks the links of the generated pages while they are rendered.
+ *
+ * Every rendered page is scanned for href/src targets and id attributes, in
+ * any quoting, in tags outside comments and scripts. Targets are resolved
+ * against the output files immediately; anchors are checked after
+ * rendering, when the ids of all pages are known.
+ */
+class LinkChecker {
+  /// A link whose anchor is checked after rendering.
+  struct Anchor {
+    std::string page;   ///< Page containing the link.
+    std::string href;   ///< Link as written.
+    std::string anchor; ///< Target page and id ("page.html#id").
+  };
+
+  std::unordered_set<std::string> files; ///< Output files (read-only).
+  ConcurrentStringSet ids;                ///< "page.html#id" of all pages.
+  std::mutex mutex;                       ///< Guards the lists below.
+  std::vector<Anchor> anchors;
+  std::vector<std::string> broken;
+  size_t linkCount = 0;
+
+  /// Decodes %XX escapes and &amp; of an attribute value.
+  static std::string decode(std::string_view value) {
+    std::string result;
+    for (size_t i = 0; i < value.size(); ++i) {
+      if (value[i] == '%' && i + 2 < value.size() &&
+          std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+          std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+        result += static_cast<char>(
+            std::stoi(std::string(value.substr(i + 1, 2)), nullptr, 16));
+        i += 2;
+      } else if (value.substr(i).starts_with("&amp;")) {
+        result += '&';
+        i += 4;
+      } else {
+        result += value[i];
+      }
+    }
+    return result;
+  }
+
+public:
+  /**
+   * @param pages Pages that will be generated.
+   */
+  explicit LinkChecker(const std::vector<Page> &pages) {
+    for (const auto &page : pages)
+      files.insert(page.activePath);
+  }
+
+  /**
+   * @brief Adds files that are not pages (assets, search index, feeds).
+   * @param paths Files relative to the output directory.
+   */
+  template <class Paths> void addFiles(const Paths &paths) {
+    for (const auto &path : paths)
+      files.emplace(path);
+  }
+
+  /**
+   * @brief Collects the links and ids of a rendered page. Thread-safe.
+   * @param page Rendered page.
+   * @param html Generated HTML.
+   */
+  void addPage(const Page &page, std::string_view html) {
+    const fs::path pageDir = fs::path(page.activePath).parent_path();
+    std::vector<Anchor> pageAnchors;
+    std::vector<std::string> pageBroken;
+    size_t pageLinks = 0;
+
+    auto visit = [&](std::string_view name, std::string_view value) {
+      if (name == "id") {
+        ids.insert(std::format("{}#{}", page.activePath, decode(value)));
+        return;
+      }
+      if (name != "href" && name != "src")
+        return;
+
+      // URLs with a scheme and absolute paths are not part of the site
+      const std::string href = decode(value);
+      const size_t pathEnd = href.find_first_of("?#");
+      const std::string path = href.substr(0, pathEnd);
+      if (path.starts_with('/') || path.find(':') != std::string::npos)
+        return;
+      ++pageLinks;
+
+      std::string target =
+          path.empty() ? page.activePath
+                       : (pageDir / path).lexically_normal().generic_string();
+      if (target.empty() || target.ends_with('/') || target == ".")
+        target = (fs::path(target) / "index.html")
+                     .lexically_normal()
+                     .generic_string();
+      if (target.starts_with("..") || !files.contains(target)) {
+        pageBroken.push_back(
+            std::format("{}: broken link '{}'", page.activePath, href));
+        return;
+      }
+
+      const size_t hash = href.find('#');
+      if (hash != std::string::npos && hash + 1 < href.size())
+        pageAnchors.push_back(
+            {page.activePath, href, target + href.substr(hash)});
+    };
+
+    // Tags: <name attr="value" attr='value' attr=value flag>
+    auto isSpace = [](char ch) {
+      return std::isspace(static_cast<unsigned char>(ch)) != 0;
+    };
+    size_t pos = 0;
+    while ((pos = html.find('<', pos)) != std::string_view::npos) {
+      ++pos;
+      if (html.substr(pos).starts_with("!--")) {
+        pos = html.find("-->", pos);
+        if (pos == std::string_view::npos)
+          break;
+        continue;
+      }
+      if (pos >= html.size() ||
+          !std::isalpha(static_cast<unsigned char>(html[pos])))
+        continue;
+      const size_t tagStart = pos;
+      while (pos < html.size() && !isSpace(html[pos]) && html[pos] != '>' &&
+             html[pos] != '/')
+        ++pos;
+      std::string tag(html.substr(tagStart, pos - tagStart));
+      std::ranges::transform(tag, tag.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+      });
+
+      while (pos < html.size() && html[pos] != '>') {
+        if (isSpace(html[pos]) || html[pos] == '/') {
+          ++pos;
+          continue;
+        }
+        const size_t nameStart = pos;
+        while (pos < html.size() && !isSpace(html[pos]) && html[pos] != '=' &&
+               html[pos] != '>' && html[pos] != '/')
+          ++pos;
+        std::string name(html.substr(nameStart, pos - nameStart));
+        std::ranges::transform(name, name.begin(), [](unsigned char ch) {
+          return static_cast<char>(std::tolower(ch));
+        });
+        while (pos < html.size() && isSpace(html[pos]))
+          ++pos;
+        if (pos >= html.size() || html[pos] != '=')
+          continue; // Attribute without value
+        ++pos;
+        while (pos < html.size() && isSpace(html[pos]))
+          ++pos;
+        if (pos >= html.size())
+          break;
+
+        size_t valueStart = pos;
+        size_t valueEnd;
+        if (html[pos] == '"' || html[pos] == '\'') {
+          valueStart = pos + 1;
+          valueEnd = html.find(html[pos], valueStart);
+          if (valueEnd == std::string_view::npos)
+            valueEnd = html.size();
+          pos = std::min(valueEnd + 1, html.size());
+        } else {
+          while (pos < html.size() && !isSpace(html[pos]) && html[pos] != '>')
+            ++pos;
+          valueEnd = pos;
+        }
+        visit(name, html.substr(valueStart, valueEnd - valueStart));
+      }
+
+      // Script and style contents are not HTML
+      if (tag == "script" || tag == "style") {
+        pos = html.find("</" + tag, pos);
+        if (pos == std::string_view::npos)
+          break;
+      }
+    }
+
+    std::lock_guard lock(mutex);
+    linkCount += pageLinks;
+    std::ranges::move(pageAnchors, std::back_inserter(anchors));
+    std::ranges::move(pageBroken, std::back_inserter(broken));
+  }
+
+  /**
+   * @brief Checks the anchors and logs the report. Call after rendering.
+   * @param log Log.
+   * @return Number of broken links and anchors.
+   */
+  size_t report(Logger &log) {
+    for (const auto &link : anchors) {
+      if (!ids.contains(link.anchor))
+        broken.push_back(
+            std::format("{}: missing anchor '{}'", link.page, link.href));
+    }
+    std::ranges::sort(broken);
+    const size_t brokenCount = broken.size();
+    for (auto &line : broken)
+      log.error(std::move(line));
+    log.info(std::format("Link check: {} links, {} broken", linkCount,
+                         brokenCount));
+    return brokenCount;
+  }
+};
+
+// --- Search Index ---
+
+/// Client for the search index, written to search/search.js.
+constexpr std::string_view searchScript = R"js(// Generated by ssg5: queries the search index in this folder.
+// Usage: ssgSearch(base_path, "query").then(results => ...), results are
+// [{title, href, score}] with href relative to the site root.
+const ssgSearch = (() => {
+  const encoder = new TextEncoder();
+  const decoder = new TextDecoder();
+  const shards = new Map();
+  let manifest = null;
+
+  const hex = (bytes) =>
+    Array.from(bytes, (b) => b.toString(16).padStart(2, "0")).join("");
+
+  // Same rules as the indexer: ASCII letters, digits, '_' and non-ASCII
+  const terms = (query) =>
+    query
+      .split(/[^A-Za-z0-9_\u0080-\uffff]+/)
+      .map((word) => word.replace(/[A-Z]/g, (c) => c.toLowerCase()))
+      .map((word) => encoder.encode(word))
+      .filter((bytes) => bytes.length >= 2 && bytes.length <= 32);
+
+  // Front-coded terms, each followed by delta+varint postings (page, count)
+  function decodeShard(bytes) {
+    let pos = 0;
+    const varint = () => {
+      let value = 0, shift = 0, byte;
+      do {
+        byte = bytes[pos++];
+        value += (byte & 0x7f) * 2 ** shift;
+        shift += 7;
+      } while (byte & 0x80);
+      return value;
+    };
+    const result = new Map();
+    let term = new Uint8Array(0);
+    for (let n = varint(); n > 0; --n) {
+      const shared = varint(), length = varint();
+      const next = new Uint8Array(shared + length);
+      next.set(term.subarray(0, shared));
+      next.set(bytes.subarray(pos, pos + length), shared);
+      pos += length;
+      term = next;
+      const postings = [];
+      let page = 0;
+      for (let count = varint(); count > 0; --count) {
+        page += varint();
+        postings.push([page, varint()]);
+      }
+      result.set(hex(term), postings);
+    }
+    return result;
+  }
+
+  async function postings(base, term) {
+    const key = hex(term);
+    const prefix = manifest.shards
+      .filter((p) => key.startsWith(p))
+      .reduce((a, b) => (b.length > a.length ? b : a), "");
+    if (!prefix) return [];
+    if (!shards.has(prefix)) {
+      const response = await fetch(`${base}search/${prefix}.bin`);
+      shards.set(prefix, decodeShard(new Uint8Array(await response.arrayBuffer())));
+    }
+    return shards.get(prefix).get(key) || [];
+  }
+
+  return async function search(base, query) {
+    if (!manifest) manifest = await (await fetch(`${base}search/index.json`)).json();
+    const words = terms(query);
+    if (words.length === 0) return [];
+
+    // Pages containing all words, ranked by tf-idf
+    let scores = null;
+    for (const word of words) {
+      const list = await postings(base, word);
+      const idf = Math.log(1 + manifest.pages.length / Math.max(list.length, 1));
+      const next = new Map();
+      for (const [page, count] of list) {
+        if (scores === null || scores.has(page))
+          next.set(page, (scores ? scores.get(page) : 0) + count * idf);
+      }
+      scores = next;
+    }
+    return [...scores]
+      .map(([page, score]) => ({ title: manifest.pages[page][0], href: manifest.pages[page][1], score }))
+      .sort((a, b) => b.score - a.score);
+  };
+})();
+)js";
+
+/**
+ * @brief Inverted index of the pages rendered by one thread.
+ */
+struct SearchIndexPart {
+  /// Term -> (page, count) in the order the pages were added.
+  std::unordered_map<std::string, std::vector<std::pair<uint32_t, uint32_t>>>
+      postings;
+
+  /**
+   * @brief Adds the words of a page.
+   * @param page Number of the page (position in reading order).
+   * @param terms Word counts of the page.
+   */
+  void addPage(uint32_t page,
+               const std::unordered_map<std::string, uint32_t> &terms) {
+    for (const auto &[term, count] : terms)
+      postings[term].emplace_back(page, count);
+  }
+};
+
+/**
+ * @brief Builds the client-side search index from per-thread partial indexes.
+ *
+ * Every render thread fills its own SearchIndexPart without locking; the
+ * parts are merged once after rendering. The index is written to search/:
+ *
+ * - index.json: page titles and hrefs, and the list of shards.
+ * - <prefix>.bin: terms starting with the (hex encoded) prefix. Terms are
+ *   sorted and front coded (shared prefix length, suffix), each followed by
+ *   its postings as varint page deltas and counts.
+ * - search.js: client that downloads only the shards of the query terms.
+ *
+ * Terms are sharded by their first byte; shards larger than shardSplitSize
+ * are split by the first two bytes.
+ */
+class SearchIndexBuilder {
+  static constexpr size_t shardSplitSize = 64 * 1024;
+
+  std::mutex mutex;                  ///< Guards parts.
+  std::deque<SearchIndexPart> parts; ///< One per render thread.
+
+  using Postings = std::vector<std::pair<uint32_t, uint32_t>>;
+  using Terms = std::vector<std::pair<std::string, Postings>>;
+
+  static void appendVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+      out += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    out += static_cast<char>(value);
+  }
+
+  static std::string hexPrefix(std::string_view term, size_t length) {
+    std::string hex;
+    for (char ch : term.substr(0, length))
+      hex += std::format("{:02x}", static_cast<unsigned char>(ch));
+    return hex;
+  }
+
+  /// Encodes sorted terms [first, last) as one shard.
+  static std::string encodeShard(Terms::const_iterator first,
+                                 Terms::const_iterator last) {
+    std::string out;
+    appendVarint(out, static_cast<uint64_t>(last - first));
+    std::string_view previous;
+    for (auto it = first; it != last; ++it) {
+      const auto &[term, postings] = *it;
+      const size_t shared =
+          std::ranges::mismatch(previous, term).in2 - term.begin();
+      appendVarint(out, shared);
+      appendVarint(out, term.size() - shared);
+      out.append(term, shared);
+      previous = term;
+
+      appendVarint(out, postings.size());
+      uint32_t page = 0;
+      for (const auto &[next, count] : postings) {
+        appendVarint(out, next - page);
+        appendVarint(out, count);
+        page = next;
+      }
+    }
+    return out;
+  }
+
+public:
+  /// Fixed files of the index, relative to the output directory.
+  static constexpr std::array<std::string_view, 2> files = {
+      "search/index.json", "search/search.js"};
+
+  /**
+   * @brief Creates the partial index of a render thread. Thread-safe.
+   * @return Partial index, owned by the builder.
+   */
+  SearchIndexPart &newPart() {
+    std::lock_guard lock(mutex);
+    return parts.emplace_back();
+  }
+
+  /**
+   * @brief Merges the partial indexes and writes the index. Call after
+   * rendering.
+   * @param output Site output.
+   * @param pages Generated pages.
+   * @param tree Navigation tree (numbers the pages in reading order).
+   * @return Number of terms.
+   */
+  size_t write(SiteOutput &output, const std::vector<Page> &pages,
+               const NavTree &tree) {
+    std::unordered_map<std::string, Postings> merged;
+    for (auto &part : parts) {
+      for (auto &[term, postings] : part.postings) {
+        auto &target = merged[term];
+        target.insert(target.end(), postings.begin(), postings.end());
+      }
+      part.postings.clear();
+    }
+
+    Terms terms(std::make_move_iterator(merged.begin()),
+                std::make_move_iterator(merged.end()));
+    std::ranges::sort(terms, {}, &Terms::value_type::first);
+    for (auto &[term, postings] : terms)
+      std::ranges::sort(postings);
+
+    const fs::path searchDir = "search";
+
+    json shardNames = json::array();
+    auto writeShard = [&](const std::string &prefix, const std::string &data) {
+      output.write(searchDir / (prefix + ".bin"), data);
+      shardNames.push_back(prefix);
+    };
+    auto shardEnd = [&](Terms::const_iterator first, size_t length) {
+      const std::string prefix = first->first.substr(0, length);
+      return std::ranges::find_if_not(first, terms.cend(), [&](const auto &t) {
+        return t.first.starts_with(prefix);
+      });
+    };
+
+    for (auto first = terms.cbegin(); first != terms.cend();) {
+      const auto last = shardEnd(first, 1);
+      std::string data = encodeShard(first, last);
+      if (data.size() <= shardSplitSize) {
+        writeShard(hexPrefix(first->first, 1), data);
+      } else {
+        for (auto sub = first; sub != last;) {
+          const auto subLast = shardEnd(sub, 2);
+          writeShard(hexPrefix(sub->first, 2), encodeShard(sub, subLast));
+          sub = subLast;
+        }
+      }
+      first = last;
+    }
+
+    json pageList = json::array();
+    for (size_t i = 0; i < tree.pageOrder.size(); ++i)
+      pageList.push_back(nullptr);
+    for (const auto &page : pages) {
+      if (page.navNode != 0)
+        pageList[tree.nodes[page.navNode].order] = {page.title,
+                                                    page.activePath};
+    }
+    output.write(searchDir / "index.json",
+                 json{{"pages", std::move(pageList)}, {"shards", shardNames}}
+                     .dump());
+    output.write(searchDir / "search.js", searchScript);
+    return terms.size();
+  }
+};
+
+// --- Taxonomies ---
+
+/**
+ * @brief Pages grouped by one front matter field (year, author or tag).
+ */
+struct Taxonomy {
+  std::string name;  ///< Output folder, e.g. "authors".
+  std::string label; ///< Title prefix, e.g. "Author".
+  std::map<std::string, std::vector<size_t>> groups; ///< Value -> pages.
+};
+
+/**
+ * @brief Converts a field value into a folder name.
+ * @param value Field value, e.g. "ZHENG Robert".
+ * @return Folder name, e.g. "zheng-robert".
+ */
+std::string slugify(std::string_view value) {
+  std::string slug;
+  for (char ch : value) {
+    const auto byte = static_cast<unsigned char>(ch);
+    if (std::isalnum(byte) || byte >= 0x80)
+      slug += static_cast<char>(std::tolower(byte));
+    else if (!slug.empty() && slug.back() != '-')
+      slug += '-';
+  }
+  while (!slug.empty() && slug.back() == '-')
+    slug.pop_back();
+  return slug.empty() ? "none" : slug;
+}
+
+/**
+ * @brief Returns a front matter field of a page.
+ * @param page Page.
+ * @param key Field name.
+ * @return Field value, empty if not set.
+ */
+std::string headerField(const Page &page, const std::string &key) {
+  if (page.header == nullptr)
+    return {};
+  const auto it = page.header->meta.find(key);
+  return it == page.header->meta.end() ? std::string()
+                                       : it->get<std::string>();
+}
+
+/**
+ * @brief Builds the year, author and tag indexes in one pass over the pages.
+ *
+ * Years come from CREATED, authors from AUTHOR, tags from the comma
+ * separated TAGS field.
+ *
+ * @param pages Pages of the site.
+ * @return Indexes (archive, authors, tags).
+ */
+std::vector<Taxonomy> buildTaxonomies(const std::vector<Page> &pages) {
+  std::vector<Taxonomy> taxonomies{
+      {"archive", "Year", {}}, {"authors", "Author", {}}, {"tags", "Tag", {}}};
+  for (size_t i = 0; i < pages.size(); ++i) {
+    const Page &page = pages[i];
+    const std::string created = headerField(page, "CREATED");
+    auto isDigit = [](char ch) {
+      return std::isdigit(static_cast<unsigned char>(ch));
+    };
+    if (created.size() >= 4 &&
+        std::all_of(created.begin(), created.begin() + 4, isDigit))
+      taxonomies[0].groups[created.substr(0, 4)].push_back(i);
+
+    const std::string author = headerField(page, "AUTHOR");
+    if (!author.empty())
+      taxonomies[1].groups[author].push_back(i);
+
+    const std::string tags = headerField(page, "TAGS");
+    for (auto tag : std::views::split(std::string_view(tags), ',')) {
+      const std::string_view name =
+          trimView(std::string_view(tag.begin(), tag.end()));
+      if (!name.empty())
+        taxonomies[2].groups[std::string(name)].push_back(i);
+    }
+  }
+  return taxonomies;
+}
+
+/**
+ * @brief Creates a generated page.
+ * @param activePath Output file relative to the site root.
+ * @param title Page title.
+ * @param cfg Config.
+ * @return Page without Markdown file.
+ */
+Page makeGeneratedPage(const fs::path &activePath, std::string title,
+                       const Config &cfg) {
+  Page page;
+  page.outputPath = cfg.outputDir / activePath;
+  page.activePath = activePath.generic_string();
+  page.backPrefix = getBackPrefix(activePath.parent_path());
+  page.title = std::move(title);
+  return page;
+}
+
+/**
+ * @brief Generates the listing pages of all taxonomies.
+ *
+ * Every value gets a paginated list of its pages, newest first
+ * (e.g. authors/zheng-robert/index.html, page-2.html, ...), and every
+ * taxonomy an overview of its values (e.g. authors/index.html). The pages
+ * are rendered with the site template like all other pages. Values with the
+ * same slug ("C++" and "C") get numbered folders ("c", "c-2").
+ *
+ * @param pages Pages of the site.
+ * @param cfg Config.
+ * @return Listing pages.
+ * @throws std::runtime_error If a taxonomy folder contains pages of the site.
+ */
+std::vector<Page> buildListingPages(const std::vector<Page> &pages,
+                                    const Config &cfg) {
+  // Sort keys, read once instead of on every comparison
+  std::vector<std::string> created(pages.size());
+  for (size_t i = 0; i < pages.size(); ++i)
+    created[i] = headerField(pages[i], "CREATED");
+
+  std::vector<Page> listings;
+  for (const auto &taxonomy : buildTaxonomies(pages)) {
+    if (taxonomy.groups.empty())
+      continue;
+
+    const fs::path taxonomyDir = taxonomy.name;
+    for (const auto &page : pages) {
+      if (page.activePath.starts_with(taxonomy.name + "/"))
+        throw std::runtime_error(std::format(
+            "Page '{}' is in the folder of the generated {} listing. Rename "
+            "the folder or set taxonomies=off.",
+            page.activePath, taxonomy.name));
+    }
+    Page overview = makeGeneratedPage(taxonomyDir / "index.html",
+                                      taxonomy.label + "s", cfg);
+    overview.content = "<ul class=\"listing\">\n";
+    json values = json::array();
+    std::unordered_set<std::string> slugs;
+
+    for (auto [value, members] : taxonomy.groups) {
+      std::ranges::stable_sort(
+          members, std::greater<>(),
+          [&](size_t i) -> const std::string & { return created[i]; });
+      std::string slug = slugify(value);
+      for (int n = 2; !slugs.insert(slug).second; ++n)
+        slug = std::format("{}-{}", slugify(value), n);
+      const fs::path valueDir = taxonomyDir / slug;
+      const size_t pageSize =
+          cfg.listingPageSize == 0 ? members.size() : cfg.listingPageSize;
+      const size_t pageCount = (members.size() + pageSize - 1) / pageSize;
+      auto fileName = [](size_t number) {
+        return number == 1 ? std::string("index.html")
+                           : std::format("page-{}.html", number);
+      };
+
+      overview.content +=
+          std::format("  <li><a href=\"{}/index.html\">", slug);
+      appendEscaped(overview.content, value);
+      overview.content += std::format("</a> ({})</li>\n", members.size());
+      values.push_back({{"name", value},
+                        {"href", (valueDir / "index.html").generic_string()},
+                        {"count", members.size()}});
+
+      for (size_t number = 1; number <= pageCount; ++number) {
+        Page listing = makeGeneratedPage(
+            valueDir / fileName(number),
+            std::format("{}: {}", taxonomy.label, value), cfg);
+
+        json items = json::array();
+        listing.content = "<ul class=\"listing\">\n";
+        const size_t end = std::min(number * pageSize, members.size());
+        for (size_t i = (number - 1) * pageSize; i < end; ++i) {
+          const Page &page = pages[members[i]];
+          const std::string &date = created[members[i]];
+          listing.content += std::format("  <li><a href=\"{}{}\">",
+                                         listing.backPrefix, page.activePath);
+          appendEscaped(listing.content, page.title);
+          listing.content += "</a>";
+          if (!date.empty()) {
+            listing.content += " <time>";
+            appendEscaped(listing.content, date);
+            listing.content += "</time>";
+          }
+          listing.content += "</li>\n";
+          items.push_back({{"title", page.title},
+                           {"href", page.activePath},
+                           {"created", date},
+                           {"author", headerField(page, "AUTHOR")}});
+        }
+        listing.content += "</ul>\n";
+
+        if (pageCount > 1) {
+          listing.content += "<nav class=\"pagination\">";
+          if (number > 1)
+            listing.content +=
+                std::format("<a href=\"{}\">&laquo; Newer</a> ",
+                            fileName(number - 1));
+          listing.content +=
+              std::format("Page {} of {}", number, pageCount);
+          if (number < pageCount)
+            listing.content += std::format(
+                " <a href=\"{}\">Older &raquo;</a>", fileName(number + 1));
+          listing.content += "</nav>\n";
+        }
+
+        listing.listing = {{"taxonomy", taxonomy.name},
+                           {"name", value},
+                           {"items", std::move(items)},
+                           {"page", number},
+                           {"pages", pageCount}};
+        listings.push_back(std::move(listing));
+      }
+    }
+    overview.content += "</ul>\n";
+    overview.listing = {{"taxonomy", taxonomy.name}, {"values", values}};
+    listings.push_back(std::move(overview));
+  }
+  return listings;
+}
+
+// --- Sitemap and Feed ---
+
+#ifdef SSG_HAVE_ZLIB
+/**
+ * @brief Compresses data in gzip format.
+ * @param data Data.
+ * @return gzip file content.
+ */
+std::string gzipCompress(std::string_view data) {
+  z_stream stream{};
+  // 15 + 16: maximum window with a gzip header
+  if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    throw std::runtime_error("Could not initialize zlib.");
+  std::string result(deflateBound(&stream, data.size()), '\0');
+  stream.next_in =
+      reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef *>(result.data());
+  stream.avail_out = static_cast<uInt>(result.size());
+  const int status = deflate(&stream, Z_FINISH);
+  result.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (status != Z_STREAM_END)
+    throw std::runtime_error("Could not compress data.");
+  return result;
+}
+#endif
+
+/**
+ * @brief Formats a file time as an RFC 3339 date (UTC).
+ * @param time File time.
+ * @return Date, e.g. "2026-01-09T12:30:00Z".
+ */
+std::string formatFileTime(fs::file_time_type time) {
+  const std::time_t seconds = std::chrono::system_clock::to_time_t(
+      std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+          std::chrono::file_clock::to_sys(time)));
+  std::tm utc{};
+  gmtime_r(&seconds, &utc);
+  char buffer[32];
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+  return buffer;
+}
+
+/**
+ * @brief Writes sitemap.xml while pages are generated.
+ *
+ * URLs are appended to the current chunk as they arrive; a chunk holds at
+ * most 50,000 URLs (the sitemap protocol limit) and is written as soon as it
+ * is full. A site with a single chunk gets a plain sitemap.xml, larger sites
+ * get sitemap-<n>.xml chunks and a sitemap.xml index.
+ */
+class SitemapWriter {
+  static constexpr size_t maxUrls = 50000;
+  static constexpr std::string_view urlsetStart =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      "<urlset xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n";
+
+  SiteOutput &output;
+  std::string siteUrl;
+  bool gzip;
+  std::string chunk; ///< XML of the current chunk.
+  size_t chunkCount = 0;
+  size_t chunkUrls = 0;
+
+  std::string chunkName(size_t number) const {
+    return std::format("sitemap-{}.xml{}", number, gzip ? ".gz" : "");
+  }
+
+  void writeChunk(const fs::path &name) {
+    if (chunk.empty())
+      chunk = urlsetStart;
+    chunk += "</urlset>\n";
+#ifdef SSG_HAVE_ZLIB
+    if (gzip)
+      chunk = gzipCompress(chunk);
+#endif
+    output.write(name, chunk);
+    chunk.clear();
+    chunkUrls = 0;
+  }
+
+public:
+  /**
+   * @param output Site output.
+   * @param siteUrl Absolute URL of the site root, without trailing '/'.
+   * @param gzip Compress the sitemap files with gzip.
+   */
+  SitemapWriter(SiteOutput &output, std::string siteUrl, bool gzip)
+      : output(output), siteUrl(std::move(siteUrl)), gzip(gzip) {
+#ifndef SSG_HAVE_ZLIB
+    if (gzip)
+      throw std::runtime_error("sitemap_gzip requires ssg5 built with zlib.");
+#endif
+  }
+
+  /**
+   * @brief Adds the URL of a page.
+   * @param path Page relative to the site root.
+   * @param lastModified Date of the last change (empty = unknown).
+   */
+  void add(std::string_view path, std::string_view lastModified) {
+    if (chunkUrls == maxUrls)
+      writeChunk(chunkName(++chunkCount));
+    if (chunk.empty())
+      chunk = urlsetStart;
+    chunk += "  <url><loc>" + siteUrl + "/";
+    appendUrlEscaped(chunk, path);
+    chunk += "</loc>";
+    if (!lastModified.empty()) {
+      chunk += "<lastmod>";
+      appendEscaped(chunk, lastModified);
+      chunk += "</lastmod>";
+    }
+    chunk += "</url>\n";
+    ++chunkUrls;
+  }
+
+  /**
+   * @brief Names of the files written for a number of pages.
+   * @param pageCount Number of pages.
+   * @return Files relative to the site root.
+   */
+  std::vector<std::string> files(size_t pageCount) const {
+    if (pageCount <= maxUrls)
+      return {gzip ? "sitemap.xml.gz" : "sitemap.xml"};
+    std::vector<std::string> names = {"sitemap.xml"};
+    for (size_t number = 1; number <= (pageCount + maxUrls - 1) / maxUrls;
+         ++number)
+      names.push_back(chunkName(number));
+    return names;
+  }
+
+  /**
+   * @brief Writes the last chunk and the index if needed.
+   */
+  void finish() {
+    if (chunkCount == 0) {
+      writeChunk(gzip ? "sitemap.xml.gz" : "sitemap.xml");
+      return;
+    }
+    writeChunk(chunkName(++chunkCount));
+
+    std::string index =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<sitemapindex "
+        "xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n";
+    for (size_t number = 1; number <= chunkCount; ++number)
+      index += std::format("  <sitemap><loc>{}/{}</loc></sitemap>\n", siteUrl,
+                           chunkName(number));
+    index += "</sitemapindex>\n";
+    output.write("sitemap.xml", index);
+  }
+};
+
+/**
+ * @brief Writes the Atom feed with the most recent pages.
+ *
+ * Only the newest entries are kept while pages are generated (a bounded
+ * heap), so memory does not grow with the size of the site.
+ */
+class AtomFeedWriter {
+  /// A feed entry, its fields are XML escaped.
+  struct Entry {
+    std::string updated;
+    std::string title;
+    std::string url;
+    std::string author;
+    std::string summary;
+  };
+  static constexpr auto newerFirst = [](const Entry &a, const Entry &b) {
+    return a.updated > b.updated;
+  };
+
+  SiteOutput &output;
+  std::string siteUrl;
+  std::string siteTitle;
+  size_t maxEntries;
+  std::vector<Entry> entries; ///< Heap, oldest entry on top.
+
+  static std::string escaped(std::string_view text) {
+    std::string result;
+    appendEscaped(result, text);
+    return result;
+  }
+
+public:
+  /**
+   * @param output Site output.
+   * @param siteUrl Absolute URL of the site root, without trailing '/'.
+   * @param siteTitle Title of the feed.
+   * @param maxEntries Number of entries.
+   */
+  AtomFeedWriter(SiteOutput &output, std::string siteUrl,
+                 std::string siteTitle, size_t maxEntries)
+      : output(output), siteUrl(std::move(siteUrl)),
+        siteTitle(std::move(siteTitle)), maxEntries(maxEntries) {}
+
+  /**
+   * @brief Offers a page to the feed.
+   * @param page Generated page.
+   * @param updated RFC 3339 date of the last change.
+   */
+  void add(const Page &page, const std::string &updated) {
+    if (maxEntries == 0 ||
+        (entries.size() == maxEntries && updated <= entries.front().updated))
+      return;
+
+    std::string url = siteUrl + "/";
+    appendUrlEscaped(url, page.activePath);
+    entries.push_back({escaped(updated), escaped(page.title), std::move(url),
+                       escaped(headerField(page, "AUTHOR")),
+                       escaped(headerField(page, "DESCRIPTION"))});
+    std::ranges::push_heap(entries, newerFirst);
+    if (entries.size() > maxEntries) {
+      std::ranges::pop_heap(entries, newerFirst);
+      entries.pop_back();
+    }
+  }
+
+  /**
+   * @brief Writes feed.xml.
+   */
+  void finish() {
+    std::ranges::sort_heap(entries, newerFirst); // newest first
+
+    const std::string title = escaped(siteTitle);
+    std::string feed = std::format(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<feed xmlns=\"http://www.w3.org/2005/Atom\">\n"
+        "  <title>{}</title>\n"
+        "  <id>{}/</id>\n"
+        "  <link href=\"{}/\"/>\n"
+        "  <link rel=\"self\" href=\"{}/feed.xml\"/>\n"
+        "  <updated>{}</updated>\n"
+        "  <author><name>{}</name></author>\n",
+        title, siteUrl, siteUrl, siteUrl,
+        entries.empty() ? formatFileTime(fs::file_time_type::clock::now())
+                        : entries.front().updated,
+        title);
+    for (const auto &entry : entries) {
+      feed += std::format("  <entry>\n"
+                          "    <title>{}</title>\n"
+                          "    <id>{}</id>\n"
+                          "    <link href=\"{}\"/>\n"
+                          "    <updated>{}</updated>\n",
+                          entry.title, entry.url, entry.url, entry.updated);
+      if (!entry.author.empty())
+        feed += std::format("    <author><name>{}</name></author>\n",
+                            entry.author);
+      if (!entry.summary.empty())
+        feed += std::format("    <summary>{}</summary>\n", entry.summary);
+      feed += "  </entry>\n";
+    }
+    feed += "</feed>\n";
+    output.write("feed.xml", feed);
+  }
+};
+
+/**
+ * @brief Collects the sitemap and the feed from the generated pages.
+ */
+class SiteFeeds {
+  std::mutex mutex; ///< Guards the writers.
+  SitemapWriter sitemap;
+  AtomFeedWriter feed;
+
+  /// Whether text is an ISO date: YYYY-MM-DD or YYYY-MM-DDThh:mm:ssZ.
+  static bool isIsoDate(std::string_view text) {
+    static constexpr std::string_view pattern = "dddd-dd-ddTdd:dd:ddZ";
+    if (text.size() != 10 && text.size() != pattern.size())
+      return false;
+    for (size_t i = 0; i < text.size(); ++i) {
+      const bool digit = std::isdigit(static_cast<unsigned char>(text[i]));
+      if (pattern[i] == 'd' ? !digit : text[i] != pattern[i])
+        return false;
+    }
+    const int month = std::stoi(std::string(text.substr(5, 2)));
+    const int day = std::stoi(std::string(text.substr(8, 2)));
+    if (month < 1 || month > 12 || day < 1 || day > 31)
+      return false;
+    if (text.size() == 10)
+      return true;
+    return std::stoi(std::string(text.substr(11, 2))) < 24 &&
+           std::stoi(std::string(text.substr(14, 2))) < 60 &&
+           std::stoi(std::string(text.substr(17, 2))) < 61; // leap second
+  }
+
+  /// Date of the last change: LAST_MODIFIED, CREATED or the file time.
+  /// Fields that are not ISO dates are ignored.
+  static std::string pageDate(const Page &page) {
+    for (const char *key : {"LAST_MODIFIED", "CREATED"}) {
+      std::string date = headerField(page, key);
+      if (!isIsoDate(date))
+        continue;
+      return date.size() == 10 ? date + "T00:00:00Z" : date;
+    }
+    return page.inputPath.empty()
+               ? std::string()
+               : formatFileTime(fs::last_write_time(page.inputPath));
+  }
+
+public:
+  /**
+   * @param cfg Config (site_url, site_title, sitemap_gzip, feed_size).
+   * @param output Site output.
+   */
+  SiteFeeds(const Config &cfg, SiteOutput &output)
+      : sitemap(output, cfg.siteUrl, cfg.sitemapGzip),
+        feed(output, cfg.siteUrl,
+             cfg.siteTitle.empty() ? cfg.siteUrl : cfg.siteTitle,
+             cfg.feedSize) {}
+
+  /**
+   * @brief Adds a generated page. Thread-safe.
+   * @param page Generated page.
+   */
+  void addPage(const Page &page) {
+    const std::string date = pageDate(page);
+    std::lock_guard lock(mutex);
+    sitemap.add(page.activePath, date.substr(0, 10));
+    // Listing pages are not part of the feed
+    if (!page.inputPath.empty())
+      feed.add(page, date);
+  }
+
+  /**
+   * @brief Names of the sitemap and feed files.
+   * @param pageCount Number of pages that will be generated.
+   * @return Files relative to the site root.
+   */
+  std::vector<std::string> files(size_t pageCount) const {
+    std::vector<std::string> names = sitemap.files(pageCount);
+    names.emplace_back("feed.xml");
+    return names;
+  }
+
+  /**
+   * @brief Finishes both files. Call after all pages are generated.
+   */
+  void finish() {
+    sitemap.finish();
+    feed.finish();
+  }
+};
+
+// --- Processing with Inja ---
+
+/**
+ * @brief Optional stages that see every generated page (nullptr = off).
+ */
+struct Stages {
+  LinkChecker *linkChecker = nullptr; ///< Checks the links of the pages.
+  SearchIndexBuilder *search = nullptr; ///< Builds the search index.
+  SiteFeeds *feeds = nullptr;           ///< Writes sitemap and feed.
+};
+
+/// Page rendered by the calling thread, read by the lazy template callbacks.
+thread_local const Page *currentPage = nullptr;
+
+/**
+ * @brief Registers callbacks that compute page values on demand.
+ *
+ * Themes can call `navigation()` instead of reading the `navigation`
+ * variable, the HTML is then only built where the template asks for it.
+ *
+ * @param env Inja environment (before the template is parsed).
+ * @param site Site-wide state.
+ */
+void addPageCallbacks(inja::Environment &env, const Site &site) {
+  env.add_callback("navigation", 0, [&site](inja::Arguments &) {
+    return json(buildNavigation(site, *currentPage));
+  });
+}
+
+/**
+ * @brief Checks whether the built-in compiled template can be used.
+ *
+ * The compiled template is only used if it was generated from exactly the
+ * configured template file, otherwise pages are rendered by runtime Inja.
+ *
+ * @param templatePath Configured template file.
+ * @return True if the compiled template matches.
+ */
+bool useCompiledTemplate(const fs::path &templatePath) {
+#ifdef SSG_COMPILED_TEMPLATE
+  if (!ssg_compiled_template::available)
+    return false;
+  inja::HashSink hash;
+  hash.append(readFile(templatePath));
+  return hash.hash() == ssg_compiled_template::source_hash;
+#else
+  (void)templatePath;
+  return false;
+#endif
+}
+
+/**
+ * @brief Renders a batch of template data with the compiled template.
+ *
+ * Same contract as inja::RenderContext::render_batch.
+ *
+ * @param first First template data.
+ * @param last End of the template data.
+ * @param site Site-wide template data.
+ * @param onRendered Called with (index, html) for every rendered page.
+ */
+template <class InputIt, class Callback>
+void renderCompiledBatch(InputIt first, InputIt last, const json &site,
+                         Callback &&onRendered) {
+#ifdef SSG_COMPILED_TEMPLATE
+  std::string buffer;
+  for (size_t index = 0; first != last; ++first, ++index) {
+    const json &data = *first;
+    buffer.clear();
+    inja::StringSink sink(buffer);
+    ssg_compiled_template::render(sink, data, site);
+    onRendered(index, std::string_view(buffer));
+  }
+#else
+  (void)first;
+  (void)last;
+  (void)site;
+  (void)onRendered;
+#endif
+}
+
+/**
+ * @brief Collects all pages of the tree.
+ * @param currentNode Current node.
+ * @param inputRoot Input root.
+ * @param cfg Config.
+ * @param pages Output list of pages.
+ */
+void collectPages(const DirNode &currentNode, const fs::path &inputRoot,
+                  const Config &cfg, std::vector<Page> &pages) {
+
+  fs::path currentOutputDir = cfg.outputDir / currentNode.relativePath;
+  std::string backPrefix = getBackPrefix(currentNode.relativePath);
+
+  for (size_t i = 0; i < currentNode.files.size(); ++i) {
+    const auto &file = currentNode.files[i];
+    fs::path targetFilename = getTargetFilename(file);
+
+    Page page;
+    page.inputPath = inputRoot / currentNode.relativePath / file;
+    page.outputPath = currentOutputDir / targetFilename;
+    page.activePath = (currentNode.relativePath / targetFilename).generic_string();
+    page.backPrefix = backPrefix;
+    page.header = &currentNode.headers[i];
+    page.title = pageTitle(file, *page.header);
+    pages.push_back(std::move(page));
+  }
+
+  for (const auto &sub : currentNode.subdirs) {
+    collectPages(sub, inputRoot, cfg, pages);
+  }
+}
+
+/**
+ * @brief Builds the template data of a page.
+ * @param page Page to render.
+ * @param site Site-wide state.
+ * @param compiled Compiled Inja template (tells which values are used).
+ * @param search Partial search index of the thread (nullptr = off).
+ * @param log Log.
+ * @return Template data.
+ */
+json buildPageData(const Page &page, const Site &site,
+                   const inja::CompiledTemplate &compiled,
+                   SearchIndexPart *search, Logger &log) {
+  currentPage = &page;
+
+  json data;
+  data["base_path"] = page.backPrefix;
+  data["title"] = page.title;
+  data["active_path"] = page.activePath;
+
+  // Values the template never reads are not computed
+  if (compiled.uses_variable("navigation"))
+    data["navigation"] = buildNavigation(site, page);
+  // Overrides the site-wide model
+  if (site.scopedNav && compiled.uses_variable("nav"))
+    data["nav"] = buildScopedNavModel(site.navTree, page.navNode);
+  if (page.navNode != 0) {
+    if (compiled.uses_variable("breadcrumbs"))
+      data["breadcrumbs"] = buildBreadcrumbs(site.navTree, page.navNode);
+    if (compiled.uses_variable("prev"))
+      data["prev"] = pageNeighbour(site.navTree, page.navNode, -1);
+    if (compiled.uses_variable("next"))
+      data["next"] = pageNeighbour(site.navTree, page.navNode, 1);
+  }
+  // Front matter is known from the pre-scan
+  if (compiled.uses_variable("meta"))
+    data["meta"] = page.header ? page.header->meta : json::object();
+
+  // Generated pages (listings) have no Markdown file
+  if (page.inputPath.empty()) {
+    data["content"] = page.content;
+    data["toc"] = json::array();
+    data["listing"] = page.listing;
+    return data;
+  }
+
+  // Heading ids and table of contents come from the same Markdown pass
+  if (compiled.uses_variable("content") || compiled.uses_variable("toc") ||
+      search) {
+    const std::string rawContent = readFile(page.inputPath);
+    const FrontMatter frontMatter = parseFrontMatter(rawContent);
+    MarkdownPage markdown = renderMarkdown(frontMatter.body, site.navTree,
+                                           page.activePath, search != nullptr);
+    // The search index lists the pages in navigation order
+    if (search && page.navNode != 0) {
+      addSearchTerms(page.title, markdown.terms);
+      search->addPage(
+          static_cast<uint32_t>(site.navTree.nodes[page.navNode].order),
+          markdown.terms);
+    }
+    for (const auto &link : markdown.brokenLinks)
+      log.warning(std::format("{}: unresolved link '{}'",
+                              page.inputPath.string(), link));
+    data["content"] = std::move(markdown.html);
+    data["toc"] = std::move(markdown.toc);
+  }
+  return data;
+}
+
+/**
+ * @brief Renders a batch of consecutive pages and writes them to the output.
+ *
+ * The template data is built lazily while the batch is rendered, the render
+ * context keeps its state and buffer across all pages. A failing page is
+ * reported and skipped, the batch continues after it.
+ *
+ * @param batch Pages to render.
+ * @param site Site-wide state.
+ * @param compiled Compiled Inja template.
+ * @param ctx Render context of the calling thread.
+ * @param useCompiled Use the compiled template.
+ * @param output Site output.
+ * @param stages Optional stages that see every page.
+ * @param search Partial search index of the thread (nullptr = off).
+ * @param log Log.
+ */
+void renderBatch(std::span<const Page> batch, const Site &site,
+                 const inja::CompiledTemplate &compiled,
+                 inja::RenderContext &ctx, bool useCompiled,
+                 SiteOutput &output, const Stages &stages,
+                 SearchIndexPart *search, Logger &log) {
+  size_t done = 0;
+  auto pageData = [&](const Page &page) {
+    return buildPageData(page, site, compiled, search, log);
+  };
+  auto writePage = [&](size_t, std::string_view html) {
+    const Page &page = batch[done++];
+    // Output errors are reported as such, the batch continues after them
+    try {
+      output.write(page.activePath, html);
+      if (stages.linkChecker)
+        stages.linkChecker->addPage(page, html);
+      if (stages.feeds)
+        stages.feeds->addPage(page);
+    } catch (const std::exception &e) {
+      log.error(std::format("Write error in {}: {}", page.activePath,
+                            e.what()));
+      return;
+    }
+    log.pageWritten(html.size());
+    if (log.enabled(LogLevel::Verbose))
+      log.verbose("Created: " + page.outputPath.string());
+  };
+
+  while (done < batch.size()) {
+    auto rest = batch.subspan(done) | std::views::transform(pageData);
+    try {
+      if (useCompiled)
+        renderCompiledBatch(rest.begin(), rest.end(), site.globals,
+                            writePage);
+      else
+        ctx.render_batch(rest.begin(), rest.end(), writePage);
+    } catch (const std::exception &e) {
+      const Page &page = batch[done++];
+      log.error(std::format("Template error in {}: {}",
+                            page.inputPath.filename().string(), e.what()));
+    }
+  }
+}
+
+/**
+ * @brief Renders all pages in parallel.
+ *
+ * The compiled template is shared read-only, every worker thread renders
+ * through its own inja::RenderContext. Workers claim batches of pages.
+ *
+ * @param pages Pages to render.
+ * @param site Site-wide state, shared read-only by all pages.
+ * @param compiled Compiled Inja template.
+ * @param threadCount Number of worker threads (0 = hardware concurrency).
+ * @param useCompiled Use the compiled template instead of Inja.
+ * @param output Site output.
+ * @param stages Optional stages that see every page.
+ * @param log Log.
+ */
+void processPages(const std::vector<Page> &pages, const Site &site,
+                  const inja::CompiledTemplate &compiled, unsigned threadCount,
+                  bool useCompiled, SiteOutput &output, const Stages &stages,
+                  Logger &log) {
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  threadCount = static_cast<unsigned>(
+      std::clamp<size_t>(threadCount, 1, std::max<size_t>(pages.size(), 1)));
+
+  // Small enough to balance the load, large enough to amortize the claim
+  constexpr size_t batchSize = 16;
+  std::atomic<size_t> nextPage{0};
+
+  auto worker = [&]() {
+    inja::RenderContext ctx(compiled);
+    ctx.set_globals(site.globals);
+    SearchIndexPart *searchPart =
+        stages.search ? &stages.search->newPart() : nullptr;
+    for (size_t begin = nextPage.fetch_add(batchSize); begin < pages.size();
+         begin = nextPage.fetch_add(batchSize)) {
+      std::span<const Page> batch(pages.data() + begin,
+                                  std::min(batchSize, pages.size() - begin));
+      renderBatch(batch, site, compiled, ctx, useCompiled, output, stages,
+                  searchPart, log);
+    }
+  };
+
+  std::vector<std::jthread> workers;
+  for (unsigned t = 1; t < threadCount; ++t)
+    workers.emplace_back(worker);
+  worker();
+}
+
+// Tests include this file with SSG5_NO_MAIN to call its functions directly
+#ifndef SSG5_NO_MAIN
+/**
+ * @brief Main entry point.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <path_to_config> <input_folder> [--check-links]"
+                 " [--verbose | --quiet]"
+              << std::endl;
+    return 1;
+  }
+
+  fs::path configPath = argv[1];
+  fs::path inputDir = argv[2];
+  bool checkLinks = false;
+  LogLevel logLevel = LogLevel::Info;
+  for (int i = 3; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--check-links")
+      checkLinks = true;
+    else if (arg == "--verbose" || arg == "-v")
+      logLevel = LogLevel::Verbose;
+    else if (arg == "--quiet" || arg == "-q")
+      logLevel = LogLevel::Warning;
+  }
+
+  // Console output is buffered and written by a background thread
+  Logger log(logLevel);
+  try {
+    Config cfg = parseConfig(configPath);
+
+    if (!fs::exists(inputDir))
+      throw std::runtime_error("Input folder does not exist.");
+    if (!fs::exists(cfg.templatePath))
+      throw std::runtime_error("Template file does not exist.");
+
+    log.info("Scanning structure (.md only)...");
+    DirNode rootNode = buildTree(inputDir, inputDir);
+    prescanHeaders(rootNode, inputDir, cfg.threads);
+
+    // A directory, or a single archive written sequentially
+    std::unique_ptr<SiteOutput> output = openOutput(cfg.outputDir, cfg.ioUring);
+
+    // --- NEW: Copy Assets ---
+    // Copies assets from the folder where template.html is located
+    std::vector<std::string> assets = copyAssets(cfg.templatePath, *output, log);
+
+    log.info("Loading template...");
+    inja::Environment env;
+    // The navigation model is built once and shared by all pages
+    Site site;
+    site.navTree = buildNavTree(rootNode);
+    site.globals["nav"] = buildNavModel(site.navTree);
+    site.scopedNav = cfg.scopedNav;
+    addPageCallbacks(env, site);
+    // Unchanged templates are loaded from the cache instead of being parsed
+    if (!cfg.templateCacheDir.empty())
+      env.set_template_cache(cfg.templateCacheDir);
+    inja::CompiledTemplate tmpl =
+        env.compile_template(cfg.templatePath.string());
+
+    bool useCompiled = useCompiledTemplate(cfg.templatePath);
+    log.info(useCompiled ? "Generating pages with compiled template..."
+                         : "Generating pages with Inja...");
+    std::vector<Page> pages;
+    collectPages(rootNode, inputDir, cfg, pages);
+    // Pages are linked to the navigation tree once, lookups are then O(1).
+    // Pages below a collapsed single-page folder are not in the navigation
+    // and keep navNode 0 like listing pages.
+    for (auto &page : pages) {
+      const auto node = site.navTree.pageIndex.find(page.activePath);
+      if (node != site.navTree.pageIndex.end())
+        page.navNode = node->second;
+    }
+    // Listing pages are rendered like all other pages
+    if (cfg.taxonomies) {
+      std::vector<Page> listings = buildListingPages(pages, cfg);
+      std::ranges::move(listings, std::back_inserter(pages));
+    }
+    // The directory skeleton is created in one pass before rendering
+    std::vector<fs::path> directories;
+    for (const auto &page : pages)
+      directories.push_back(fs::path(page.activePath).parent_path());
+    if (cfg.searchIndex)
+      directories.emplace_back("search");
+    output->createDirectories(directories);
+    // Words are counted while the Markdown is rendered
+    std::unique_ptr<SearchIndexBuilder> search;
+    if (cfg.searchIndex)
+      search = std::make_unique<SearchIndexBuilder>();
+    // Links are collected while the pages are rendered
+    std::unique_ptr<LinkChecker> linkChecker;
+    if (checkLinks) {
+      linkChecker = std::make_unique<LinkChecker>(pages);
+      linkChecker->addFiles(assets);
+      if (search)
+        linkChecker->addFiles(SearchIndexBuilder::files);
+    }
+    // Sitemap and feed are written while the pages are generated
+    std::unique_ptr<SiteFeeds> feeds;
+    if (!cfg.siteUrl.empty())
+      feeds = std::make_unique<SiteFeeds>(cfg, *output);
+    if (linkChecker && feeds)
+      linkChecker->addFiles(feeds->files(pages.size()));
+    log.startProgress(pages.size());
+    processPages(pages, site, tmpl, cfg.threads, useCompiled, *output,
+                 {linkChecker.get(), search.get(), feeds.get()}, log);
+    log.stopProgress();
+    if (search) {
+      size_t termCount = search->write(*output, pages, site.navTree);
+      log.info(std::format("Search index: {} terms", termCount));
+    }
+    if (feeds)
+      feeds->finish();
+    output->finish();
+
+    log.info("Done! Output in: " + cfg.outputDir.string());
+    if (linkChecker)
+      linkChecker->report(log);
+
+  } catch (const std::exception &e) {
+    log.stopProgress();
+    log.error(e.what());
+  }
+
+  // Broken links, template and write errors are logged, not thrown
+  const int status = log.errors() > 0 ? 1 : 0;
+  log.summary();
+  log.stop();
+  return status;
+}
+#endif // SSG5_NO_MAIN
@@ -0,0 +1,393 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Compiles an Inja template into a C++ render function
+ */
+
+/**
+ * @file template_codegen.cpp
+ * @brief Inja template to C++ code generator
+ *
+ * Parses an Inja template (e.g. assets4/template.html) and writes a C++
+ * translation unit with a render function for it. Static text becomes
+ * constexpr string_view segments (adjacent text and literals are merged), variables are looked up and written
+ * directly, so rendering is reduced to a few appends per page.
+ *
+ * Supported: text, {{ variable }}, {{ literal }} and if/else on a variable.
+ * Literals are printed at generation time and become static text. For any
+ * other feature (loops, functions, includes, ...), HTML autoescape or a
+ * variable that a callback of the environment may answer, the generated unit
+ * reports itself as unavailable and ssg5 falls back to runtime Inja.
+ *
+ * The generated unit defines (namespace ssg_compiled_template):
+ * - available:   false if the template uses unsupported features.
+ * - source_hash: FNV-1a hash of the template, to detect a different theme.
+ * - render():    renders the template for a page (page data, site globals).
+ *
+ * Usage:
+ * ssg_template_codegen <template.html> <output.cpp>
+ */
+
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Libraries
+#include <inja.hpp>
+
+namespace fs = std::filesystem;
+
+// --- Helpers ---
+
+/**
+ * @brief Formats text as a C++ string literal, split into short lines.
+ * @param text Raw text.
+ * @param indent Indentation of continuation lines.
+ * @return C++ source of the literal.
+ */
+std::string cppLiteral(std::string_view text, const std::string &indent) {
+  std::string result = "\"";
+  size_t lineLength = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char ch = text[i];
+    switch (ch) {
+    case '\"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '?': // avoid trigraphs
+      result += "\\?";
+      break;
+    default:
+      if (static_cast<unsigned char>(ch) < 0x20 ||
+          static_cast<unsigned char>(ch) >= 0x7f) {
+        // Octal escapes have a fixed length, unlike \x
+        result += std::format("\\{:03o}", static_cast<unsigned char>(ch));
+      } else {
+        result += ch;
+      }
+    }
+    if ((++lineLength >= 72 || ch == '\n') && i + 1 < text.size()) {
+      result += "\"\n" + indent + "\"";
+      lineLength = 0;
+    }
+  }
+  result += "\"";
+  return result;
+}
+
+/**
+ * @brief Formats a value like the runtime renderer prints it (no escaping).
+ * @param value Value of an expression.
+ * @return Printed text.
+ */
+std::string printedText(const inja::json &value) {
+  auto number = [](auto n) {
+    std::array<char, 24> buffer;
+    const auto result =
+        std::to_chars(buffer.data(), buffer.data() + buffer.size(), n);
+    return std::string(buffer.data(), result.ptr);
+  };
+  if (value.is_string())
+    return value.get<std::string>();
+  if (value.is_number_unsigned())
+    return number(value.get<inja::json::number_unsigned_t>());
+  if (value.is_number_integer())
+    return number(value.get<inja::json::number_integer_t>());
+  if (value.is_null())
+    return {};
+  return value.dump();
+}
+
+// --- Code Generator ---
+
+/**
+ * @brief Walks the template AST and emits C++ statements for it.
+ */
+class CodeGenerator : public inja::NodeVisitor {
+  const inja::Template &tmpl;
+  const inja::FunctionStorage &functions;
+  std::string indent = "  ";
+  size_t segmentCount = 0;
+  std::string text; ///< Static text not emitted yet.
+
+  /// Emits the pending static text as one segment.
+  void flushText() {
+    if (text.empty())
+      return;
+    const size_t index = segmentCount++;
+    segments += std::format(
+        "constexpr std::string_view segment_{} {{\n    {}}};\n", index,
+        cppLiteral(text, "    "));
+    body += std::format("{}out.append(segment_{});\n", indent, index);
+    text.clear();
+  }
+
+  /// Emits the lookup of a variable, throwing like the runtime renderer.
+  std::string lookup(const inja::DataNode &node) {
+    // The renderer calls a callback of that name if the data lacks it
+    if (functions.find_function(node.name, 0).operation ==
+        inja::FunctionStorage::Operation::Callback)
+      unsupported(std::format("variable '{}' shadowed by a callback",
+                              node.name));
+    const auto loc = inja::get_source_location(tmpl.content, node.pos);
+    return std::format("lookup(data, globals, {}, {}, {}, {})",
+                       cppLiteral(node.name, ""),
+                       cppLiteral(node.ptr.to_string(), ""), loc.line,
+                       loc.column);
+  }
+
+  void visit(const inja::BlockNode &node) override {
+    for (const auto &n : node.nodes)
+      n->accept(*this);
+  }
+
+  void visit(const inja::TextNode &node) override {
+    text += std::string_view(tmpl.content).substr(node.pos, node.length);
+  }
+
+  void visit(const inja::ExpressionListNode &node) override {
+    if (auto data = std::dynamic_pointer_cast<inja::DataNode>(node.root)) {
+      flushText();
+      body += std::format("{}print(out, {});\n", indent, lookup(*data));
+    } else if (auto literal =
+                   std::dynamic_pointer_cast<inja::LiteralNode>(node.root)) {
+      // Static text like the text around it
+      text += printedText(literal->value);
+    } else {
+      unsupported("expressions other than variables and literals");
+    }
+  }
+
+  void visit(const inja::IfStatementNode &node) override {
+    auto data = std::dynamic_pointer_cast<inja::DataNode>(node.condition.root);
+    if (!data) {
+      unsupported("if conditions other than a single variable");
+      return;
+    }
+    flushText();
+    body += std::format("{}if (truthy({})) {{\n", indent, lookup(*data));
+    indent += "  ";
+    node.true_statement.accept(*this);
+    flushText();
+    indent.resize(indent.size() - 2);
+    if (node.has_false_statement) {
+      body += indent + "} else {\n";
+      indent += "  ";
+      node.false_statement.accept(*this);
+      flushText();
+      indent.resize(indent.size() - 2);
+    }
+    body += indent + "}\n";
+  }
+
+  void visit(const inja::ExpressionNode &) override {
+    unsupported("expressions");
+  }
+  void visit(const inja::LiteralNode &) override { unsupported("literals"); }
+  void visit(const inja::DataNode &) override { unsupported("variables"); }
+  void visit(const inja::FunctionNode &) override {
+    unsupported("functions");
+  }
+  void visit(const inja::StatementNode &) override {
+    unsupported("statements");
+  }
+  void visit(const inja::ForStatementNode &) override {
+    unsupported("for loops");
+  }
+  void visit(const inja::ForArrayStatementNode &) override {
+    unsupported("for loops");
+  }
+  void visit(const inja::ForObjectStatementNode &) override {
+    unsupported("for loops");
+  }
+  void visit(const inja::IncludeStatementNode &) override {
+    unsupported("include");
+  }
+  void visit(const inja::ExtendsStatementNode &) override {
+    unsupported("extends");
+  }
+  void visit(const inja::BlockStatementNode &) override {
+    unsupported("blocks");
+  }
+  void visit(const inja::SetStatementNode &) override {
+    unsupported("set");
+  }
+
+public:
+  /// Generates segments and body for the whole template.
+  void generate() {
+    tmpl.root.accept(*this);
+    flushText();
+  }
+
+  void unsupported(std::string_view feature) {
+    if (supported)
+      reason = feature;
+    supported = false;
+  }
+
+  bool supported = true; ///< False if the template needs runtime Inja.
+  std::string reason;    ///< First unsupported feature.
+  std::string segments;  ///< Definitions of the static text segments.
+  std::string body;      ///< Statements of the render function.
+
+  CodeGenerator(const inja::Template &tmpl,
+                const inja::FunctionStorage &functions)
+      : tmpl(tmpl), functions(functions) {}
+};
+
+/**
+ * @brief Generates the translation unit for a template.
+ * @param templatePath Path of the template (for the header comment).
+ * @param compiled Parsed template with the render config and callbacks of
+ * its environment.
+ * @return C++ source.
+ */
+std::string generateSource(const fs::path &templatePath,
+                           const inja::CompiledTemplate &compiled) {
+  const inja::Template &tmpl = compiled.get_template();
+  CodeGenerator generator(tmpl, compiled.get_function_storage());
+  // The generated print() writes strings as they are
+  if (compiled.get_render_config().html_autoescape)
+    generator.unsupported("HTML autoescape");
+  else
+    generator.generate();
+
+  inja::HashSink hash;
+  hash.append(tmpl.content);
+
+  std::string source = std::format(
+      "// Generated by ssg_template_codegen from {}. Do not edit.\n\n"
+      "#include <array>\n"
+      "#include <charconv>\n"
+      "#include <cstdint>\n"
+      "#include <string>\n"
+      "#include <string_view>\n\n"
+      "#include <inja.hpp>\n\n"
+      "namespace ssg_compiled_template {{\n\n"
+      "extern const bool available = {};\n"
+      "extern const std::uint64_t source_hash = {}ULL;\n\n",
+      templatePath.filename().string(), generator.supported ? "true" : "false",
+      hash.hash());
+
+  if (!generator.supported) {
+    source += std::format("// Unsupported: {}, ssg5 uses runtime Inja.\n"
+                          "void render(inja::OutputSink &, const inja::json &,\n"
+                          "            const inja::json &) {{}}\n\n"
+                          "}} // namespace ssg_compiled_template\n",
+                          generator.reason);
+    return source;
+  }
+
+  source += "namespace {\n\n" + generator.segments + R"(
+const inja::json *find(const inja::json &data, std::string_view name,
+                       std::string_view ptr) {
+  if (name.find('.') == std::string_view::npos) {
+    const auto it = data.find(name);
+    return (it != data.end()) ? &*it : nullptr;
+  }
+  const inja::json::json_pointer jsonPtr{std::string(ptr)};
+  return data.contains(jsonPtr) ? &data[jsonPtr] : nullptr;
+}
+
+// Page data first, then the site globals, like inja::RenderContext
+const inja::json &lookup(const inja::json &data, const inja::json &globals,
+                         std::string_view name, std::string_view ptr,
+                         size_t line, size_t column) {
+  const inja::json *value = find(data, name, ptr);
+  if (value == nullptr)
+    value = find(globals, name, ptr);
+  if (value == nullptr)
+    INJA_THROW(inja::RenderError(
+        "variable '" + std::string(name) + "' not found", {line, column}));
+  return *value;
+}
+
+bool truthy(const inja::json &value) {
+  if (value.is_boolean())
+    return value.get<bool>();
+  if (value.is_number())
+    return value != 0;
+  if (value.is_null())
+    return false;
+  return !value.empty();
+}
+
+template <class T> void printNumber(inja::OutputSink &out, T value) {
+  std::array<char, 24> buffer;
+  const auto result =
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+  out.append(buffer.data(), static_cast<size_t>(result.ptr - buffer.data()));
+}
+
+void print(inja::OutputSink &out, const inja::json &value) {
+  if (value.is_string())
+    out.append(value.get_ref<const inja::json::string_t &>());
+  else if (value.is_number_unsigned())
+    printNumber(out, value.get<inja::json::number_unsigned_t>());
+  else if (value.is_number_integer())
+    printNumber(out, value.get<inja::json::number_integer_t>());
+  else if (!value.is_null())
+    out.append(value.dump());
+}
+
+} // namespace
+
+void render(inja::OutputSink &out, const inja::json &data,
+            const inja::json &globals) {
+)" + generator.body +
+            "}\n\n} // namespace ssg_compiled_template\n";
+  return source;
+}
+
+#ifndef SSG_CODEGEN_NO_MAIN
+/**
+ * @brief Main entry point.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <template.html> <output.cpp>"
+              << std::endl;
+    return 1;
+  }
+
+  fs::path templatePath = argv[1];
+  fs::path outputPath = argv[2];
+
+  try {
+    inja::Environment env;
+    std::string source =
+        generateSource(templatePath, env.compile_template(templatePath.string()));
+
+    std::ofstream out(outputPath, std::ios::out | std::ios::binary);
+    if (!out)
+      throw std::runtime_error(
+          std::format("Could not write file: {}", outputPath.string()));
+    out << source;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+#endif // SSG_CODEGEN_NO_MAIN
@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Minimal check helpers for the ssg tests
+ */
+
+/**
+ * @file check.hpp
+ * @brief Minimal check helpers for the ssg tests
+ *
+ * Each test is a small executable registered with ctest. Checks print the
+ * failing case and count it, main() returns check::result().
+ */
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace check {
+
+inline int failures = 0;
+
+/// Reports a failed check unless condition holds
+inline void that(bool condition, std::string_view name) {
+  if (!condition) {
+    std::cerr << "FAILED: " << name << "\n";
+    ++failures;
+  }
+}
+
+/// Reports a failed check with both values unless actual equals expected
+inline void equal(const std::string &actual, const std::string &expected, std::string_view name) {
+  if (actual != expected) {
+    std::cerr << "FAILED: " << name << "\n  expected: \"" << expected << "\"\n  actual:   \"" << actual << "\"\n";
+    ++failures;
+  }
+}
+
+/// Exit status of the test executable
+inline int result() {
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed\n";
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace check
@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Test of the dependencies of the inja template cache
+ */
+
+/**
+ * @file test_inja_cache.cpp
+ * @brief Test of the dependencies of the inja template cache
+ *
+ * A cache entry must list every template the cached template includes or
+ * extends, directly or through other includes, even if an earlier parse in
+ * the same environment already loaded them. A new environment (like a new
+ * process) loading only that entry must render like a fresh parse, and a
+ * changed include must invalidate it.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string render(const std::filesystem::path &dir, const std::string &name) {
+  inja::Environment env(dir.string() + "/");
+  env.set_template_cache(dir / "cache");
+  const auto tmpl = env.parse_template(name);
+  return env.render(tmpl, json{{"name", "x"}});
+}
+
+} // namespace
+
+int main() {
+  const auto dir = std::filesystem::temp_directory_path() / "ssg_test_inja_cache";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "cache");
+  std::ofstream(dir / "a.html") << "A{% include \"partial.html\" %}";
+  std::ofstream(dir / "b.html") << "B{% if name %}{% include \"partial.html\" %}{% endif %}";
+  std::ofstream(dir / "c.html") << "{% extends \"base.html\" %}{% block body %}C{% endblock %}";
+  std::ofstream(dir / "base.html") << "<{% block body %}{% endblock %}>{% include \"partial.html\" %}";
+  std::ofstream(dir / "partial.html") << "[{% include \"inner.html\" %}]";
+  std::ofstream(dir / "inner.html") << "{{ name }}";
+
+  // One environment parses all templates, the includes are loaded by the first
+  {
+    inja::Environment env(dir.string() + "/");
+    env.set_template_cache(dir / "cache");
+    for (const char *name : {"a.html", "b.html", "c.html"})
+      env.parse_template(name);
+  }
+
+  // New environments load a single entry each
+  check::equal(render(dir, "b.html"), "B[x]", "include loaded by an earlier parse");
+  check::equal(render(dir, "c.html"), "<C>[x]", "extends and its includes");
+  check::equal(render(dir, "a.html"), "A[x]", "first parse");
+
+  // A nested include is a dependency as well
+  std::ofstream(dir / "inner.html") << "{{ name }}!";
+  check::equal(render(dir, "b.html"), "B[x!]", "changed nested include");
+  check::equal(render(dir, "b.html"), "B[x!]", "changed nested include, loaded from the cache");
+
+  std::filesystem::remove_all(dir);
+  return check::result();
+}
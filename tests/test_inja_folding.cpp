@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Equivalence test of folded and unfolded templates
+ */
+
+/**
+ * @file test_inja_folding.cpp
+ * @brief Equivalence test of folded and unfolded templates
+ *
+ * Every template is parsed with and without constant folding and rendered
+ * with the same data. Both must give the same output, or both must fail.
+ * The templates use all built-in functions on constants, constants mixed
+ * with data, static and dynamic if conditions, loops, set and includes.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+const std::vector<std::string> templates = {
+    // Arithmetic and comparisons
+    "{{ 1 + 2 }} {{ 7 - 10 }} {{ 3 * 4 }} {{ 7 / 2 }} {{ 8 / 4 }} {{ 7 % 3 }} {{ 2 ^ 10 }} {{ 1.5 * 2 }}",
+    "{{ 1 == 1 }} {{ 1 != 1 }} {{ 2 > 1 }} {{ 2 >= 3 }} {{ 1 < 2 }} {{ 1 <= 0 }} {{ \"a\" == \"a\" }}",
+    "{{ true and false }} {{ true or false }} {{ not true }} {{ 1 in [1, 2] }} {{ \"c\" in [\"a\", \"b\"] }}",
+    "{{ (1 + 2) * 3 }} {{ 1 + 2 * 3 }} {{ 10 / 0 }}",
+    // Built-in functions
+    "{{ upper(\"Hello\") }} {{ lower(\"Hello\") }} {{ capitalize(\"hELLO\") }} {{ replace(\"a-b-c\", \"-\", \"+\") }}",
+    "{{ length(\"four\") }} {{ length([1, 2, 3]) }} {{ first([4, 5]) }} {{ last([4, 5]) }} {{ sort([3, 1, 2]) }}",
+    "{{ max([1, 9, 3]) }} {{ min([4, 2, 8]) }} {{ range(4) }} {{ join([1, \"a\", 2], \", \") }} {{ at([1, 2], 1) }}",
+    "{{ round(3.14159, 2) }} {{ int(\"42\") }} {{ float(\"1.5\") }} {{ odd(3) }} {{ even(3) }} {{ divisibleBy(9, 3) }}",
+    "{{ isArray([1]) }} {{ isBoolean(1) }} {{ isFloat(1.5) }} {{ isInteger(2) }} {{ isNumber(\"x\") }} {{ isObject({}) }} {{ isString(\"s\") }}",
+    "{{ default(\"\", \"fallback\") }} {{ default(missing, \"fallback\") }} {{ at({\"a\": 1}, \"a\") }}",
+    // Constants mixed with data, data-dependent functions are not folded
+    "{{ title }} {{ length(items) + 1 }} {{ upper(title) }} {{ exists(\"title\") }} {{ existsIn(meta, \"a\") }} {{ shout(\"x\") }}",
+    "{% if count > 1 + 1 %}many{% else %}few{% endif %} {{ count * (2 + 3) }} <b>raw</b>",
+    // Static and dynamic if conditions, nested
+    "{% if 1 < 2 %}A{% if false %}B{% else %}C{% if title %}D{% endif %}{% endif %}{% else %}E{% endif %}",
+    "{% if length([1, 2]) == 2 and true %}yes{% endif %}{% if not (1 == 1) %}no{% endif %}{% if 0 %}zero{% endif %}",
+    // Loops, set and includes
+    "{% for i in range(3) %}{{ i * 2 }}{% if loop.is_last %}.{% else %},{% endif %}{% endfor %}",
+    "{% for x in [1, 2, 3] %}{% set sum = default(sum, 0) + x %}{% endfor %}{{ upper(\"sum\") }}={{ sum }}",
+    "{% set greeting = upper(\"hi \") %}{{ greeting }}{{ title }}{% for k, v in {\"b\": 2, \"a\": 1} %}{{ k }}={{ v + 1 }};{% endfor %}",
+    "{% include \"part\" %}|{% for item in items %}{% include \"part\" %}{% endfor %}",
+    "{# comment #}{{ \"<escaped & quoted>\" }}{{ upper(\"<b>\") }}",
+};
+
+const json data = {{"title", "Docs <&>"}, {"items", {"a", "b", "c"}}, {"count", 3}, {"meta", {{"a", 1}}}};
+
+/// Renders source with or without folding, failures are reported as "error"
+std::string render(const std::string &source, bool fold, bool autoescape) {
+  inja::Environment env;
+  env.set_constant_folding(fold);
+  env.set_html_autoescape(autoescape);
+  env.add_callback("shout", 1, [](inja::Arguments &args) { return args.at(0)->get<std::string>() + "!"; });
+  env.include_template("part", env.parse("[{{ upper(\"part\") }} {% if 2 > 1 %}{{ length(items) }}{% endif %}]"));
+  try {
+    return env.render(source, data);
+  } catch (const inja::InjaError &error) {
+    return std::string("error: ") + error.what();
+  }
+}
+
+/// Whether the first expression of source was folded into a literal
+bool foldedToLiteral(const std::string &source) {
+  inja::Environment env;
+  env.add_callback("shout", 1, [](inja::Arguments &args) { return args.at(0)->get<std::string>() + "!"; });
+  const auto tmpl = env.parse(source);
+  for (const auto &node : tmpl.root.nodes) {
+    if (const auto expression = std::dynamic_pointer_cast<inja::ExpressionListNode>(node)) {
+      return std::dynamic_pointer_cast<inja::LiteralNode>(expression->root) != nullptr;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+int main() {
+  for (const bool autoescape : {false, true}) {
+    for (const auto &source : templates) {
+      check::equal(render(source, true, autoescape), render(source, false, autoescape), source);
+    }
+  }
+
+  check::that(foldedToLiteral("{{ 1 + 2 }}"), "constant expression is folded");
+  check::that(foldedToLiteral("{{ upper(\"a\") }}"), "constant function call is folded");
+  check::that(!foldedToLiteral("{{ upper(title) }}"), "expression with data is not folded");
+  check::that(!foldedToLiteral("{{ shout(\"a\") }}"), "callback is not folded");
+  return check::result();
+}
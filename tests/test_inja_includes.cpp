@@ -0,0 +1,117 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Equivalence test of pre-resolved and looked up includes
+ */
+
+/**
+ * @file test_inja_includes.cpp
+ * @brief Equivalence test of pre-resolved and looked up includes
+ *
+ * Include and extends nodes point to the template they were resolved to at
+ * parse time. Rendering through these pointers must give the same output as
+ * looking every include up by name, which the renderer does for any other
+ * template storage (here a copy of the environment's storage). Includes
+ * replaced or added after parsing must be used like before.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+/// Renders with a copy of the storage, so every include is looked up by name
+std::string renderByName(const inja::Environment &env, const inja::Template &tmpl, const json &data) {
+  const inja::TemplateStorage copy(env.compile(tmpl).get_template_storage());
+  std::string result;
+  inja::StringSink sink(result);
+  inja::Renderer(inja::RenderConfig(), copy, inja::FunctionStorage()).render_to(sink, tmpl, data);
+  return result;
+}
+
+/// Whether the first include node of tmpl was resolved at parse time
+bool firstIncludeResolved(const inja::Template &tmpl) {
+  for (const auto &node : tmpl.root.nodes) {
+    if (const auto include = std::dynamic_pointer_cast<inja::IncludeStatementNode>(node)) {
+      return include->resolved != nullptr;
+    }
+  }
+  return false;
+}
+
+const json data = {{"title", "Docs"}, {"items", {"a", "b"}}, {"user", {{"name", "Jane"}}}};
+
+void testNamedIncludes() {
+  inja::Environment env;
+  env.set_search_included_templates_in_files(false);
+  env.include_template("item", env.parse("<li>{{ loop.index1 }}. {{ item }}</li>"));
+  env.include_template("list", env.parse("<ul>{% for item in items %}{% include \"item\" %}{% endfor %}</ul>"));
+  env.include_template("base", env.parse("<h1>{% block title %}{{ title }}{% endblock %}</h1>{% block body %}{% endblock %}"));
+
+  const auto page = env.parse("{% include \"list\" %}|{% include \"list\" %}");
+  check::that(firstIncludeResolved(page), "include is resolved at parse time");
+  check::equal(env.render(page, data), renderByName(env, page, data), "nested includes");
+
+  const auto child = env.parse("{% extends \"base\" %}{% block body %}{% include \"list\" %}{% endblock %}");
+  check::equal(env.render(child, data), renderByName(env, child, data), "extends with include in a block");
+
+  // Replacing an include after parsing is seen by both
+  env.include_template("item", env.parse("<li>{{ item }}!</li>"));
+  check::equal(env.render(page, data), "<ul><li>a!</li><li>b!</li></ul>|<ul><li>a!</li><li>b!</li></ul>", "replaced include");
+  check::equal(renderByName(env, page, data), env.render(page, data), "replaced include, by name");
+
+  // An include that did not exist at parse time is looked up when rendering
+  const auto later = env.parse("{% include \"later\" %}");
+  check::that(!firstIncludeResolved(later), "missing include is not resolved");
+  env.include_template("later", env.parse("later {{ user.name }}"));
+  check::equal(env.render(later, data), "later Jane", "include added after parsing");
+
+  // A template rendered by another environment uses that environment's includes
+  inja::Environment other;
+  other.include_template("item", other.parse("[{{ item }}]"));
+  other.include_template("list", other.parse("{% for item in items %}{% include \"item\" %}{% endfor %}"));
+  check::equal(other.render(page, data), "[a][b]|[a][b]", "template rendered by another environment");
+}
+
+void testFileIncludes() {
+  const auto dir = std::filesystem::temp_directory_path() / "ssg_test_inja_includes";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "partials");
+  std::ofstream(dir / "page.html") << "{% extends \"layout.html\" %}{% block main %}{% include \"partials/nav.html\" %}{% endblock %}";
+  std::ofstream(dir / "layout.html") << "<title>{{ title }}</title><main>{% block main %}{% endblock %}</main>{% include \"partials/footer.html\" %}";
+  std::ofstream(dir / "partials/nav.html") << "{% for item in items %}<a>{{ item }}</a>{% endfor %}";
+  std::ofstream(dir / "partials/footer.html") << "<footer>{{ user.name }}</footer>";
+
+  inja::Environment env(dir.string() + "/");
+  const auto page = env.parse_template("page.html");
+  check::equal(env.render(page, data), "<title>Docs</title><main><a>a</a><a>b</a></main><footer>Jane</footer>", "file includes");
+  check::equal(renderByName(env, page, data), env.render(page, data), "file includes, by name");
+
+  // Includes from the include callback
+  inja::Environment callbackEnv;
+  callbackEnv.set_search_included_templates_in_files(false);
+  callbackEnv.set_include_callback([&](const std::filesystem::path &, const std::string &name) { return callbackEnv.parse("<" + name + ">"); });
+  const auto fromCallback = callbackEnv.parse("{% include \"a\" %}{% include \"b\" %}{% include \"a\" %}");
+  check::equal(callbackEnv.render(fromCallback, data), "<a><b><a>", "includes from the callback");
+  check::equal(renderByName(callbackEnv, fromCallback, data), "<a><b><a>", "includes from the callback, by name");
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  testNamedIncludes();
+  testFileIncludes();
+  return check::result();
+}
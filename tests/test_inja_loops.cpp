@@ -0,0 +1,138 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Regression tests for inja loops bound by reference
+ */
+
+/**
+ * @file test_inja_loops.cpp
+ * @brief Regression tests for inja loops bound by reference
+ *
+ * Loops point into the iterated value instead of copying it. A set in the
+ * loop body that replaces the iterated value, one of its parents, or grows
+ * it must not invalidate the running loop, and included templates must see
+ * the loop variables of the including template. A loop variable still acts
+ * like a copy of the element: a set of it changes neither the iterated value
+ * nor a variable of the same name outside the loop, which is left with the
+ * cleared last value after the loop. Run under ASan to catch dangling
+ * references that happen to print the right output.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+void testSetInLoopBody() {
+  inja::Environment env;
+  const json data = {{"page", {{"items", {"a", "b", "c"}}}}};
+
+  check::equal(env.render("{% set page = {\"items\": [1, 2, 3]} %}"
+                          "{% for x in page.items %}{% set page = {} %}{{ x }}{% endfor %}",
+                          data),
+               "123", "set replaces the parent of the iterated array");
+  check::equal(env.render("{% for x in page.items %}{% set page = 1 %}{{ x }}{% endfor %}", data), "abc",
+               "set shadows the parent of an iterated render data array");
+  check::equal(env.render("{% set arr = [1, 2] %}{% for x in arr %}{% set arr.5 = 1 %}{{ x }}{% endfor %}|{{ length(arr) }}", data),
+               "12|6", "set grows the iterated array");
+  check::equal(env.render("{% set obj = {\"a\": 1, \"b\": 2} %}"
+                          "{% for k, v in obj %}{% set obj.c = 3 %}{{ k }}={{ v }};{% endfor %}",
+                          data),
+               "a=1;b=2;", "set adds a key to the iterated object");
+  check::equal(env.render("{% set rows = [[1, 2], [3]] %}"
+                          "{% for row in rows %}{% for x in row %}{% set rows = [] %}{{ x }}{% endfor %};{% endfor %}",
+                          data),
+               "12;3;", "set in a nested loop replaces the outer array");
+  check::equal(env.render("{% set rows = [[1, 2], [3]] %}"
+                          "{% for row in rows %}{% if true %}{% set rows.0 = [] %}{% endif %}{{ length(row) }}{% endfor %}",
+                          data),
+               "21", "set inside an if of the loop body");
+}
+
+void testSetOfLoopVariable() {
+  inja::Environment env;
+  const json data = {{"items", {1, 2}}, {"x", {{"a", "data"}}}};
+
+  check::equal(env.render("{% set arr = [1, 2] %}{% for x in arr %}{% set x = 5 %}{{ x }}{% endfor %}|{{ x }}|{{ arr }}", data),
+               "55|0|[1,2]", "set of the loop variable does not alias the array");
+  check::equal(env.render("{% set arr = [{\"b\": 2}] %}{% for x in arr %}{% set x.a = 1 %}{{ x }}{% endfor %}|{{ arr }}", data),
+               "{\"a\":1,\"b\":2}|[{\"b\":2}]", "set below the loop variable changes a copy of the element");
+  check::equal(env.render("{% for x in items %}{% set x = 0 %}{{ x }}{% endfor %}|{{ items }}", data), "00|[1,2]",
+               "set of the loop variable does not change the render data");
+  check::equal(env.render("{% for x in [1, 2] %}{% if x == 1 %}{% set x = 7 %}{% endif %}{{ x }}{% endfor %}", data), "72",
+               "next iteration binds the next element again");
+  check::equal(env.render("{% set obj = {\"k\": 1} %}"
+                          "{% for k, v in obj %}{% set v = 2 %}{% set k = \"z\" %}{{ k }}={{ v }}{% endfor %}|{{ obj }}|{{ k }}|{{ v }}",
+                          data),
+               "z=2|{\"k\":1}||0", "set of the key and value of an object loop");
+  check::equal(env.render("{% for x in [{\"b\": 1}] %}{{ x.a }}{% endfor %}", data), "data",
+               "missing member of the loop variable falls back to the render data");
+}
+
+void testLoopVariableShadowsSet() {
+  inja::Environment env;
+  const json data = json::object();
+
+  check::equal(env.render("{% set x = \"outer\" %}{% for x in [1, 2] %}{{ x }}{% endfor %}|{{ x }}", data), "12|0",
+               "loop variable replaces a set of the same name");
+  check::equal(env.render("{% set x = \"outer\" %}{% for x in [1, 2] %}{% set y = 1 %}{{ x }}{% endfor %}|{{ x }}", data), "12|0",
+               "loop with a set in the body");
+  check::equal(env.render("{% set x = \"outer\" %}{% for x in [\"a\", \"b\"] %}{{ x }}{% endfor %}|{{ x }}", data), "ab|",
+               "cleared string element");
+  check::equal(env.render("{% set x = \"outer\" %}{% for x in [] %}{% endfor %}[{{ x }}]", data), "[]", "empty loop clears the set");
+  check::equal(env.render("{% for x in [1, 2] %}{% for x in [3] %}{{ x }}{% endfor %}{{ x }}{% endfor %}", data), "3030",
+               "nested loop over the same name");
+  check::equal(env.render("{% set x = [[1, 2], [3]] %}{% for a in x %}{% for x in a %}{{ x }}{% endfor %};{% endfor %}", data), "12;3;",
+               "inner loop variable named like the outer array");
+}
+
+void testIncludeInLoop() {
+  inja::Environment env;
+  env.include_template("cell", env.parse("{{ x }}:{{ loop.index }}:{{ loop.parent.index }}:{{ row.0 }}"));
+  env.include_template("flat", env.parse("{{ x }}:{{ loop.index }}:{{ row.0 }}"));
+  env.include_template("row", env.parse("{% for x in row %}{% include \"cell\" %} {% endfor %}"));
+
+  const json data = {{"rows", {{"a", "b"}, {"c"}}}};
+  check::equal(env.render("{% for row in rows %}{% for x in row %}{% include \"cell\" %} {% endfor %}{% endfor %}", data),
+               "a:0:0:a b:1:0:a c:0:1:c ", "include sees loop variables and loop.parent");
+  check::equal(env.render("{% for row in rows %}{% include \"row\" %}{% endfor %}", data), "a:0:0:a b:1:0:a c:0:1:c ",
+               "nested include sees the loops of both including templates");
+  check::equal(env.render("{% for row in rows %}{% include \"flat\" %};{% endfor %}", {{"rows", {{"a"}}}, {"x", "y"}}),
+               "y:0:a;", "include outside of the inner loop falls back to the render data");
+}
+
+void testTemplateCache() {
+  const auto dir = std::filesystem::temp_directory_path() / "ssg_test_inja_loops";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "cache");
+  std::ofstream(dir / "loop.html") << "{% set arr = [1, 2] %}{% for x in arr %}{% set arr = [] %}{{ x }}{% endfor %}";
+
+  for (int pass = 0; pass < 2; ++pass) {
+    inja::Environment env(dir.string() + "/");
+    env.set_template_cache(dir / "cache");
+    const auto tmpl = env.parse_template("loop.html");
+    check::equal(env.render(tmpl, json::object()), "12", pass == 0 ? "loop with set, parsed" : "loop with set, loaded from the cache");
+  }
+  std::filesystem::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  testSetInLoopBody();
+  testSetOfLoopVariable();
+  testLoopVariableShadowsSet();
+  testIncludeInLoop();
+  testTemplateCache();
+  return check::result();
+}
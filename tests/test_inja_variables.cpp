@@ -0,0 +1,108 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Equivalence test of rendering with only the used variables
+ */
+
+/**
+ * @file test_inja_variables.cpp
+ * @brief Equivalence test of rendering with only the used variables
+ *
+ * ssg5 only computes the page values a theme reads, as reported by
+ * CompiledTemplate::uses_variable. Rendering with only those values must
+ * give the same output as rendering with all of them, for the shipped theme
+ * and for templates using includes, loops, set, exists and callbacks.
+ */
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+std::string readFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+/// Every value ssg5 can put into the page data, and one no template reads
+json fullPageData() {
+  return {
+      {"base_path", "../"},
+      {"title", "Page"},
+      {"active_path", "docs/page.html"},
+      {"navigation", "<ul><li>Home</li></ul>"},
+      {"nav", {{{"title", "Home"}, {"url", "index.html"}, {"children", json::array()}}}},
+      {"breadcrumbs", {{{"title", "Docs"}, {"url", "docs/index.html"}}}},
+      {"prev", {{"title", "Previous"}, {"url", "prev.html"}}},
+      {"next", nullptr},
+      {"meta", {{"AUTHOR", "Jane"}, {"CREATED", "2024-05-01"}}},
+      {"content", "<p>Body</p>"},
+      {"toc", {{{"level", 2}, {"id", "intro"}, {"title", "Intro"}}}},
+      {"listing", {{"kind", "tag"}, {"pages", json::array()}}},
+      {"unused", "never read"},
+  };
+}
+
+/// Keeps only the values the compiled template reports as used
+json usedPageData(const inja::CompiledTemplate &compiled, const json &full) {
+  json result = json::object();
+  for (const auto &[key, value] : full.items()) {
+    if (compiled.uses_variable(key)) {
+      result[key] = value;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+int main() {
+  inja::Environment env;
+  env.add_callback("upper", 1, [](inja::Arguments &args) {
+    std::string text = args.at(0)->get<std::string>();
+    for (auto &c : text) {
+      c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return text;
+  });
+  env.include_template("crumbs", env.parse("{% for c in breadcrumbs %}<a href=\"{{ base_path }}{{ c.url }}\">{{ c.title }}</a>{% endfor %}"));
+  env.include_template("toc", env.parse("{% for h in toc %}<a href=\"#{{ h.id }}\">{{ h.title }}</a>{% endfor %}"));
+
+  const std::vector<std::pair<std::string, std::string>> templates = {
+      {"assets4/template.html", readFile(SSG_SOURCE_DIR "/assets4/template.html")},
+      {"include", "{% include \"crumbs\" %}|{% include \"toc\" %}|{{ title }}"},
+      {"loop and set", "{% set page_title = upper(title) %}{{ page_title }}{% for item in nav %}{{ item.title }}{% endfor %}"},
+      {"exists", "{% if exists(\"navigation\") %}has navigation{% endif %}{% if exists(\"meta.AUTHOR\") %}by {{ meta.AUTHOR }}{% endif %}"},
+      {"exists computed name", "{% set name = \"prev\" %}{% if exists(name) %}has prev{% else %}no prev{% endif %}"},
+      {"existsIn and default", "{% if existsIn(meta, \"CREATED\") %}{{ meta.CREATED }}{% endif %}{{ default(prev.title, \"-\") }}"},
+      {"listing", "{% if listing %}{{ listing.kind }}{% endif %}{% if next %}{{ next.url }}{% endif %}"},
+  };
+
+  const json full = fullPageData();
+  for (const auto &[name, source] : templates) {
+    const inja::CompiledTemplate compiled = env.compile(env.parse(source));
+    inja::RenderContext context(compiled);
+    const std::string expected(context.render(full));
+    check::equal(std::string(context.render(usedPageData(compiled, full))), expected, name);
+  }
+
+  const inja::CompiledTemplate theme = env.compile(env.parse(templates[0].second));
+  check::that(theme.uses_variable("content") && !theme.uses_variable("unused"), "theme reads only some values");
+  const inja::CompiledTemplate computed = env.compile(env.parse(templates[4].second));
+  check::that(computed.uses_variable("unused"), "computed exists() name uses every value");
+  return check::result();
+}
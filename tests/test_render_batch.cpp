@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Equivalence test of batch and single renders
+ */
+
+/**
+ * @file test_render_batch.cpp
+ * @brief Equivalence test of batch and single renders
+ *
+ * Batch renders reuse one renderer and output buffer for all pages. Every
+ * page must render exactly as a fresh single render, so no state (set
+ * variables, loops, extends, a failed render) may leak into the next page.
+ */
+
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Sets a variable only on some pages, a later page must not see it
+const char *const pageTemplate = R"({% extends "base" %}{% block body %}{% if draft %}{% set note = "draft" %}{% endif %})"
+                                 R"({{ default(note, "final") }}: {% for item in items %}{{ loop.index1 }}={{ item }} {% endfor %})"
+                                 R"({% include "footer" %}{% endblock %})";
+
+json makePage(size_t index) {
+  json items = json::array();
+  for (size_t i = 0; i < (index * 7) % 5; ++i) {
+    items.push_back("item" + std::to_string(i));
+  }
+  return {{"title", "Page " + std::to_string(index)}, {"draft", index % 3 == 0}, {"items", items}};
+}
+
+} // namespace
+
+int main() {
+  inja::Environment env;
+  env.include_template("base", env.parse("<h1>{{ title }}</h1>{% block body %}{% endblock %}<hr>"));
+  env.include_template("footer", env.parse("<footer>{{ length(items) }} items</footer>"));
+  const inja::Template tmpl = env.parse(pageTemplate);
+
+  std::vector<json> pages;
+  std::vector<std::string> expected;
+  for (size_t i = 0; i < 20; ++i) {
+    pages.push_back(makePage(i));
+    expected.push_back(env.render(tmpl, pages.back()));
+  }
+
+  size_t count = 0;
+  env.render_batch(tmpl, pages.begin(), pages.end(), [&](size_t index, std::string_view output) {
+    check::equal(std::string(output), expected[index], "Environment::render_batch page " + std::to_string(index));
+    ++count;
+  });
+  check::that(count == pages.size(), "Environment::render_batch renders every page");
+
+  // Contexts built lazily, the iterator yields the json by value
+  inja::RenderContext context(env.compile(tmpl));
+  auto lazy = std::views::iota(size_t {0}, pages.size()) | std::views::transform(makePage);
+  count = 0;
+  context.render_batch(lazy.begin(), lazy.end(), [&](size_t index, std::string_view output) {
+    check::equal(std::string(output), expected[index], "RenderContext::render_batch page " + std::to_string(index));
+    ++count;
+  });
+  check::that(count == pages.size(), "RenderContext::render_batch renders every page");
+
+  // A failed render leaves no state behind
+  const std::vector<json> withError = {pages[0], json {{"title", "broken"}}, pages[1]};
+  bool failed = false;
+  try {
+    context.render_batch(withError.begin(), withError.end(), [](size_t, std::string_view) {});
+  } catch (const inja::RenderError &) {
+    failed = true;
+  }
+  check::that(failed, "render_batch reports the failing page");
+  check::equal(std::string(context.render(pages[1])), expected[1], "render after a failed render");
+  return check::result();
+}
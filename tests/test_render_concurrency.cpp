@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Stress test for concurrent rendering of a compiled template
+ */
+
+/**
+ * @file test_render_concurrency.cpp
+ * @brief Stress test for concurrent rendering of a compiled template
+ *
+ * Many threads render one shared CompiledTemplate, each through its own
+ * RenderContext, with shared globals and a callback, while the Environment
+ * it was compiled from keeps changing its includes. Every output must equal
+ * the single-threaded render of the same page. Build the tests with
+ * -DSSG_TEST_SANITIZER=thread to let TSan check the shared state.
+ */
+
+#include <atomic>
+#include <cctype>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Libraries
+#include <inja.hpp>
+
+#include "check.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr size_t threadCount = 8;
+constexpr size_t pageCount = 400;
+constexpr int rounds = 5;
+
+const char *const pageTemplate = R"(<title>{{ title }} - {{ site.name }}</title>
+{% set count = length(items) %}{% for item in items %}{% include "item" %}{% endfor %}
+{% for key, value in meta %}{{ key }}={{ value }};{% endfor %}
+{% if count > 2 %}many{% else %}few{% endif %} {{ shout(title) }} {{ content }})";
+
+json makePage(size_t index) {
+  json page;
+  page["title"] = "Page <" + std::to_string(index) + ">";
+  page["content"] = std::string(index % 97, 'x') + "&" + std::to_string(index);
+  page["items"] = json::array();
+  for (size_t i = 0; i < index % 5; ++i) {
+    page["items"].push_back({{"name", "item " + std::to_string(i)}, {"url", "/p/" + std::to_string(index) + "/" + std::to_string(i)}});
+  }
+  page["meta"] = {{"index", index}, {"odd", index % 2 == 1}};
+  return page;
+}
+
+} // namespace
+
+int main() {
+  inja::Environment env;
+  env.add_callback("shout", 1, [](inja::Arguments &args) {
+    std::string text = args.at(0)->get<std::string>();
+    for (auto &c : text) {
+      c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return text;
+  });
+  env.include_template("item", env.parse(R"(<a href="{{ item.url }}">{{ loop.index1 }}. {{ item.name }}</a>{% if not loop.is_last %}, {% endif %})"));
+  const inja::CompiledTemplate compiled = env.compile(env.parse(pageTemplate));
+  const json globals = {{"site", {{"name", "Docs & more"}}}};
+
+  std::vector<json> pages;
+  std::vector<std::string> expected;
+  {
+    inja::RenderContext context(compiled);
+    context.set_globals(globals);
+    for (size_t i = 0; i < pageCount; ++i) {
+      pages.push_back(makePage(i));
+      expected.emplace_back(context.render(pages.back()));
+    }
+  }
+
+  std::atomic<size_t> mismatches {0};
+  std::atomic<bool> rendering {true};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < threadCount; ++t) {
+    threads.emplace_back([&, t] {
+      inja::RenderContext context(compiled);
+      context.set_globals(globals);
+      for (int round = 0; round < rounds; ++round) {
+        // Each thread walks the pages in a different order, so all of them render different pages at the same time
+        for (size_t n = 0; n < pageCount; ++n) {
+          const size_t i = (n * (2 * t + 1) + t) % pageCount;
+          if (context.render(pages[i]) != expected[i]) {
+            ++mismatches;
+          }
+        }
+      }
+    });
+  }
+
+  // Changing the environment must not affect templates compiled before
+  std::thread writer([&] {
+    for (int i = 0; rendering; ++i) {
+      env.include_template("item", env.parse("changed " + std::to_string(i)));
+    }
+  });
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  rendering = false;
+  writer.join();
+
+  check::that(mismatches == 0, "concurrent renders equal the single-threaded render");
+  check::that(env.render("{% include \"item\" %}", json::object()).starts_with("changed"), "environment sees its changed include");
+  return check::result();
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Test of the ssg5 link checker's attribute scan
+ */
+
+/**
+ * @file test_ssg5_links.cpp
+ * @brief Test of the ssg5 link checker's attribute scan
+ *
+ * Only the id, href and src attributes of tags are links or anchors, in any
+ * quoting and case. Attributes ending in these names (data-id, data-href),
+ * text that looks like an attribute, comments and scripts are not. Links to
+ * the sitemap and feed files are known files.
+ */
+
+#define SSG5_NO_MAIN
+#include "../src/main5.cpp"
+
+#include "check.hpp"
+
+namespace {
+
+Page makePage(const std::string &activePath) {
+  Page page;
+  page.activePath = activePath;
+  return page;
+}
+
+/// Records the names of the written files
+class NameOutput : public SiteOutput {
+public:
+  std::set<std::string> names;
+
+  void write(const fs::path &path, std::string_view) override { names.insert(path.generic_string()); }
+};
+
+/// Number of broken links and anchors when the pages link to each other
+size_t brokenCount(const std::vector<std::pair<std::string, std::string>> &site,
+                   const std::vector<std::string> &files = {}) {
+  std::vector<Page> pages;
+  for (const auto &[path, html] : site)
+    pages.push_back(makePage(path));
+  LinkChecker checker(pages);
+  checker.addFiles(files);
+  for (size_t i = 0; i < pages.size(); ++i)
+    checker.addPage(pages[i], site[i].second);
+  Logger log(LogLevel::Error);
+  return checker.report(log);
+}
+
+} // namespace
+
+int main() {
+  const std::string target = "<h2 id=\"intro\">Intro</h2><p ID='single'>x</p><div id = spaced>y</div>";
+  check::that(brokenCount({{"a.html", "<a href=\"b.html#intro\">"}, {"b.html", target}}) == 0, "double quotes");
+  check::that(brokenCount({{"a.html", "<a href='b.html#single'>"}, {"b.html", target}}) == 0, "single quotes and upper case id");
+  check::that(brokenCount({{"a.html", "<a\nclass=\"x\"\nHREF = b.html#spaced>"}, {"b.html", target}}) == 0, "unquoted and spaced");
+  check::that(brokenCount({{"a.html", "<img src='missing.png' alt=\"x\">"}}) == 1, "single-quoted src is checked");
+  check::that(brokenCount({{"a.html", "<a href=\"#nowhere\">"}}) == 1, "missing anchor");
+
+  // Not links or anchors
+  check::that(brokenCount({{"a.html", "<a href=\"#x\"></a><div data-id=\"x\">"}}) == 1, "data-id is not an id");
+  check::that(brokenCount({{"a.html", "<span data-href=\"missing.html\" data-src='missing.png'>"}}) == 0,
+              "data-href and data-src are not links");
+  check::that(brokenCount({{"a.html", "<p>Set href=\"missing.html\" or src='x.png' in the config</p>"}}) == 0,
+              "text is not an attribute");
+  check::that(brokenCount({{"a.html", "<!-- <a href=\"missing.html\"> --><p title=\"a > b\" lang=en>x</p>"}}) == 0,
+              "comments");
+  check::that(brokenCount({{"a.html", "<script>const a = '<a href=\"' + url + '\">';</script><style>a[href=\"x\"] {}</style>"}}) == 0,
+              "scripts and styles");
+  check::that(brokenCount({{"a.html", "<script src=\"missing.js\"></script>"}}) == 1, "script src is checked");
+
+  // Sitemap and feed, the files named in advance are the files written
+  Config cfg;
+  cfg.siteUrl = "https://example.com";
+  for (const size_t pageCount : {1, 50000, 100001}) {
+    for (const bool gzip : {false, true}) {
+#ifndef SSG_HAVE_ZLIB
+      if (gzip)
+        continue;
+#endif
+      cfg.sitemapGzip = gzip;
+      NameOutput output;
+      SiteFeeds feeds(cfg, output);
+      const std::vector<std::string> files = feeds.files(pageCount);
+      Page page = makePage("a.html");
+      for (size_t i = 0; i < pageCount; ++i)
+        feeds.addPage(page);
+      feeds.finish();
+      check::that(std::set<std::string>(files.begin(), files.end()) == output.names,
+                  std::format("feed files of {} pages{}", pageCount, gzip ? ", gzip" : ""));
+    }
+  }
+  cfg.sitemapGzip = false;
+  NameOutput output;
+  check::that(brokenCount({{"a.html", "<link href=\"feed.xml\"><a href=\"sitemap.xml\">"}},
+                          SiteFeeds(cfg, output).files(1)) == 0,
+              "links to feed and sitemap");
+  return check::result();
+}
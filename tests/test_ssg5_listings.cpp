@@ -0,0 +1,111 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Test of the ssg5 listing pages
+ */
+
+/**
+ * @file test_ssg5_listings.cpp
+ * @brief Test of the ssg5 listing pages
+ *
+ * Values whose slugs collide ("C++" and "C", case, values without letters)
+ * must get their own folders, listings are sorted newest first, and pages
+ * in a taxonomy folder of the input are reported instead of being mixed
+ * with the listings.
+ */
+
+#define SSG5_NO_MAIN
+#include "../src/main5.cpp"
+
+#include "check.hpp"
+
+namespace {
+
+struct TestSite {
+  std::vector<PageHeader> headers;
+  std::vector<Page> pages;
+
+  void add(const std::string &activePath, const std::string &created, const std::string &tags) {
+    PageHeader header;
+    header.meta = {{"CREATED", created}, {"TAGS", tags}};
+    headers.push_back(std::move(header));
+    Page page;
+    page.activePath = activePath;
+    page.title = activePath;
+    pages.push_back(std::move(page));
+  }
+
+  std::vector<Page> listings() {
+    for (size_t i = 0; i < pages.size(); ++i)
+      pages[i].header = &headers[i];
+    return buildListingPages(pages, Config{});
+  }
+};
+
+const Page *findListing(const std::vector<Page> &listings, const std::string &activePath) {
+  for (const auto &listing : listings) {
+    if (listing.activePath == activePath)
+      return &listing;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+int main() {
+  TestSite site;
+  site.add("a.html", "2024-01-01", "C++, C, docs, all");
+  site.add("b.html", "2026-03-01", "c, Docs, !!!, ???, all");
+  site.add("c.html", "2025-06-01", "c-2, all");
+  const auto listings = site.listings();
+
+  std::unordered_set<std::string> paths;
+  for (const auto &listing : listings)
+    check::that(paths.insert(listing.activePath).second, "unique listing page " + listing.activePath);
+
+  // std::map order: "!!!", "???", "C", "C++", "Docs", "all", "c", "c-2", "docs"
+  const std::vector<std::pair<std::string, std::string>> expected = {
+      {"!!!", "tags/none/index.html"},  {"???", "tags/none-2/index.html"}, {"C", "tags/c/index.html"},
+      {"C++", "tags/c-2/index.html"},   {"Docs", "tags/docs/index.html"},  {"all", "tags/all/index.html"},
+      {"c", "tags/c-3/index.html"},     {"c-2", "tags/c-2-2/index.html"},  {"docs", "tags/docs-2/index.html"}};
+  const Page *overview = findListing(listings, "tags/index.html");
+  check::that(overview != nullptr, "tag overview");
+  if (overview != nullptr) {
+    const json &values = overview->listing["values"];
+    check::that(values.size() == expected.size(), "one entry per tag");
+    for (size_t i = 0; i < std::min(values.size(), expected.size()); ++i) {
+      check::equal(values[i]["name"].get<std::string>(), expected[i].first, "tag name");
+      check::equal(values[i]["href"].get<std::string>(), expected[i].second, "tag folder of " + expected[i].first);
+      check::that(findListing(listings, expected[i].second) != nullptr, "listing page of " + expected[i].first);
+    }
+  }
+
+  // Newest first
+  const Page *all = findListing(listings, "tags/all/index.html");
+  check::that(all != nullptr && all->listing["items"].size() == 3, "tag with every page");
+  if (all != nullptr && all->listing["items"].size() == 3) {
+    const json &items = all->listing["items"];
+    check::equal(items[0]["href"].get<std::string>() + items[1]["href"].get<std::string>() + items[2]["href"].get<std::string>(),
+                 "b.htmlc.htmla.html", "newest first");
+  }
+  const Page *docs = findListing(listings, "tags/docs/index.html");
+  check::that(docs != nullptr && docs->listing["items"].size() == 1, "Docs and docs are listed separately");
+
+  // Pages in a taxonomy folder
+  TestSite clash;
+  clash.add("tags/cpp.html", "2024-01-01", "cpp");
+  bool failed = false;
+  try {
+    clash.listings();
+  } catch (const std::runtime_error &) {
+    failed = true;
+  }
+  check::that(failed, "page in the tags folder is an error");
+
+  TestSite similar;
+  similar.add("tagsmore/a.html", "2024-01-01", "x");
+  check::that(!similar.listings().empty(), "similar folder name is no error");
+  return check::result();
+}
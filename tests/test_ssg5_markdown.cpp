@@ -0,0 +1,100 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Golden test of the ssg5 Markdown renderer against md4c-html
+ */
+
+/**
+ * @file test_ssg5_markdown.cpp
+ * @brief Golden test of the ssg5 Markdown renderer against md4c-html
+ *
+ * ssg5 renders the md4c parse events itself to add heading ids and collect
+ * the table of contents. Apart from the heading ids, the HTML must equal
+ * md4c-html's (with verbatim entities) for every Markdown file of the
+ * repository and for a file using every GitHub dialect feature. Entities in
+ * headings are decoded for the id and kept in the TOC title.
+ */
+
+#define SSG5_NO_MAIN
+#include "../src/main5.cpp"
+
+#include <regex>
+
+#include <md4c-html.h>
+
+#include "check.hpp"
+
+namespace {
+
+std::string readFile(const fs::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+std::string renderWithMd4cHtml(std::string_view markdown) {
+  std::string html;
+  md_html(
+      markdown.data(), static_cast<MD_SIZE>(markdown.size()),
+      [](const MD_CHAR *text, MD_SIZE size, void *out) { static_cast<std::string *>(out)->append(text, size); }, &html,
+      MD_DIALECT_GITHUB, MD_HTML_FLAG_VERBATIM_ENTITIES);
+  return html;
+}
+
+/// Removes the heading ids, md4c-html has none
+std::string withoutHeadingIds(std::string html) {
+  static const std::regex headingId("<h([1-6]) id=\"[^\"]*\">");
+  return std::regex_replace(html, headingId, "<h$1>");
+}
+
+void testGolden() {
+  std::vector<fs::path> files = {SSG_SOURCE_DIR "/tests/data/markdown_features.md"};
+  for (const auto &entry : fs::directory_iterator(SSG_SOURCE_DIR)) {
+    if (entry.path().extension() == ".md")
+      files.push_back(entry.path());
+  }
+  for (const char *dir : {"/docs", "/input"}) {
+    for (const auto &entry : fs::recursive_directory_iterator(SSG_SOURCE_DIR + std::string(dir))) {
+      if (entry.path().extension() == ".md")
+        files.push_back(entry.path());
+    }
+  }
+
+  // No known pages, so no link is rewritten
+  const NavTree tree;
+  for (const auto &file : files) {
+    const std::string markdown = readFile(file);
+    check::equal(withoutHeadingIds(renderMarkdown(markdown, tree, "page.html").html), renderWithMd4cHtml(markdown),
+                 file.lexically_relative(SSG_SOURCE_DIR).generic_string());
+  }
+}
+
+void testHeadingEntities() {
+  const MarkdownPage page =
+      renderMarkdown("# Tom &amp; Jerry\n\n## Caf&eacute; &#x41;&nbsp;la &unknown; carte\n\n## Tom &amp; Jerry\n", NavTree{},
+                     "page.html");
+  check::that(page.toc.size() == 3, "toc has every heading");
+  if (page.toc.size() != 3)
+    return;
+  check::equal(page.toc[0]["id"].get<std::string>(), "tom--jerry", "entity id");
+  check::equal(page.toc[0]["title"].get<std::string>(), "Tom &amp; Jerry", "entity title");
+  check::equal(page.toc[1]["id"].get<std::string>(), "caf\xC3\xA9-a-la--carte", "decoded entities id");
+  check::equal(page.toc[1]["title"].get<std::string>(), "Caf&eacute; &#x41;&nbsp;la &unknown; carte", "entities title");
+  check::equal(page.toc[2]["id"].get<std::string>(), "tom--jerry-1", "repeated entity id");
+  check::that(page.html.starts_with("<h1 id=\"tom--jerry\">Tom &amp; Jerry</h1>\n"), "heading html");
+
+  std::string decoded;
+  for (const char *entity : {"&lt;", "&#62;", "&#x20AC;", "&uuml;", "&#0;", "&#x110000;"})
+    check::that(appendDecodedEntity(decoded, entity), entity);
+  check::equal(decoded, "<>\xE2\x82\xAC\xC3\xBC\xEF\xBF\xBD\xEF\xBF\xBD", "decoded entities");
+  check::that(!appendDecodedEntity(decoded, "&nope;") && !appendDecodedEntity(decoded, "&#xZZ;"), "unknown entities");
+}
+
+} // namespace
+
+int main() {
+  testGolden();
+  testHeadingEntities();
+  return check::result();
+}
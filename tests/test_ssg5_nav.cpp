@@ -0,0 +1,193 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Equivalence test of the ssg5 navigation model
+ */
+
+/**
+ * @file test_ssg5_nav.cpp
+ * @brief Equivalence test of the ssg5 navigation model
+ *
+ * The navigation HTML is generated from the shared navigation model. For
+ * every page it must equal the HTML of the original generator, which walked
+ * the directory tree directly. A theme rendering the model from the site
+ * globals in Inja must be able to reproduce the same HTML. Pages below a
+ * collapsed single-page folder are not in the navigation but still render.
+ * Titles from front matter and folder names are HTML-escaped.
+ */
+
+#define SSG5_NO_MAIN
+#include "../src/main5.cpp"
+
+#include "check.hpp"
+
+namespace {
+
+/// The navigation generator before the navigation model (walks the directory tree)
+void referenceNavHtml(const DirNode &currentNode, std::string &html, const std::string &urlPrefix,
+                      const fs::path &activeTargetFile) {
+  html += "<ul class=\"nav-list\">\n";
+  for (const auto &file : currentNode.files) {
+    const fs::path fullLinkPath = currentNode.relativePath / getTargetFilename(file);
+    const std::string classAttr = (fullLinkPath == activeTargetFile) ? " class=\"active\"" : "";
+    html += std::format("  <li><a href=\"{}{}\"{}>{}</a></li>\n", urlPrefix, fullLinkPath.generic_string(), classAttr,
+                        file.stem().string());
+  }
+  for (const auto &sub : currentNode.subdirs) {
+    if (sub.files.size() == 1) {
+      const fs::path linkPath = sub.relativePath / getTargetFilename(sub.files[0]);
+      const std::string classAttr = (linkPath == activeTargetFile) ? " class=\"active\"" : "";
+      html += std::format("  <li><a href=\"{}{}\"{}>{}</a></li>\n", urlPrefix, linkPath.generic_string(), classAttr, sub.dirName);
+    } else {
+      html += std::format("  <li><strong>{}</strong>\n", sub.dirName);
+      referenceNavHtml(sub, html, urlPrefix, activeTargetFile);
+      html += "  </li>\n";
+    }
+  }
+  html += "</ul>\n";
+}
+
+/// Keeps the pages in memory
+class MemoryOutput : public SiteOutput {
+public:
+  std::mutex mutex;
+  std::map<std::string, std::string> files;
+
+  void write(const fs::path &path, std::string_view content) override {
+    std::lock_guard lock(mutex);
+    files[path.generic_string()] = std::string(content);
+  }
+};
+
+/// Headers are not scanned, so titles are the file names like in the original generator
+void clearHeaders(DirNode &node) {
+  node.headers.assign(node.files.size(), PageHeader{});
+  for (auto &sub : node.subdirs)
+    clearHeaders(sub);
+}
+
+/// The navigation HTML as an Inja theme, rendering the model from the globals with a recursive include
+const char *const navListTemplate =
+    "<ul class=\"nav-list\">\n"
+    "{% for item in items %}{% if item.is_folder %}  <li><strong>{{ item.title }}</strong>\n"
+    "{% set items = item.children %}{% include \"nav_list\" %}  </li>\n"
+    "{% else %}  <li><a href=\"{{ base_path }}{{ item.href }}\"{% if item.href == active_path %} class=\"active\"{% endif %}>"
+    "{{ item.title }}</a></li>\n{% endif %}{% endfor %}</ul>\n";
+
+void checkSite(const fs::path &inputRoot, const std::string &name) {
+  DirNode root = buildTree(inputRoot, inputRoot);
+  clearHeaders(root);
+
+  Site site;
+  site.navTree = buildNavTree(root);
+  site.globals["nav"] = buildNavModel(site.navTree);
+  std::vector<Page> pages;
+  collectPages(root, inputRoot, Config{}, pages);
+  for (auto &page : pages) {
+    const auto node = site.navTree.pageIndex.find(page.activePath);
+    if (node != site.navTree.pageIndex.end())
+      page.navNode = node->second;
+  }
+  check::that(!pages.empty(), name + ": site has pages");
+
+  inja::Environment env;
+  env.set_search_included_templates_in_files(false);
+  env.include_template("nav_list", env.parse(navListTemplate));
+  inja::RenderContext context(env.compile(env.parse("{% set items = nav %}{% include \"nav_list\" %}")));
+  context.set_globals(site.globals);
+
+  for (const auto &page : pages) {
+    std::string expected;
+    referenceNavHtml(root, expected, page.backPrefix, page.activePath);
+    check::equal(buildNavigation(site, page), expected, name + ": " + page.activePath);
+
+    const json data = {{"base_path", page.backPrefix}, {"active_path", page.activePath}};
+    check::equal(std::string(context.render(data)), expected, name + ": theme, " + page.activePath);
+  }
+
+  // Every page renders, in the navigation or not
+  inja::Environment pageEnv;
+  const inja::CompiledTemplate compiled = pageEnv.compile(pageEnv.parse(
+      "{{ navigation }}{% if exists(\"breadcrumbs\") %}{{ length(breadcrumbs) }}{% endif %}"
+      "{% if exists(\"prev\") %}{{ prev }}{% endif %}{% if exists(\"next\") %}{{ next }}{% endif %}{{ content }}"));
+  inja::RenderContext pageContext(compiled);
+  MemoryOutput output;
+  SearchIndexPart search;
+  size_t errorCount = 0;
+  {
+    Logger log(LogLevel::Error);
+    renderBatch(pages, site, compiled, pageContext, false, output, Stages{}, &search, log);
+    errorCount = log.errors();
+  }
+  check::that(errorCount == 0, name + ": no render errors");
+  for (const auto &page : pages)
+    check::that(output.files.contains(page.activePath), name + ": rendered " + page.activePath);
+}
+
+/// Titles and folder names with HTML special characters
+void checkEscapedTitles(const fs::path &dir) {
+  fs::remove_all(dir);
+  for (const char *file : {"a.md", "b.md", "x & y/one.md", "x & y/two.md"}) {
+    fs::create_directories((dir / file).parent_path());
+    std::ofstream(dir / file) << "# Page\n";
+  }
+  DirNode root = buildTree(dir, dir);
+  clearHeaders(root);
+  for (size_t i = 0; i < root.files.size(); ++i) {
+    if (root.files[i].stem() == "a")
+      root.headers[i].title = "A <b> & C";
+  }
+
+  Site site;
+  site.navTree = buildNavTree(root);
+  site.globals["nav"] = buildNavModel(site.navTree);
+  Page page;
+  page.activePath = "b.html";
+  page.navNode = site.navTree.pageIndex.at(page.activePath);
+  const std::string html = buildNavigation(site, page);
+  check::that(html.find(">A &lt;b&gt; &amp; C</a>") != std::string::npos, "escaped title");
+  check::that(html.find("<strong>x &amp; y</strong>") != std::string::npos, "escaped folder name");
+
+  inja::Environment env;
+  env.set_search_included_templates_in_files(false);
+  env.include_template("nav_list", env.parse(navListTemplate));
+  inja::RenderContext context(env.compile(env.parse("{% set items = nav %}{% include \"nav_list\" %}")));
+  context.set_globals(site.globals);
+  check::equal(std::string(context.render(json{{"base_path", ""}, {"active_path", page.activePath}})), html,
+               "escaped titles, theme");
+  check::equal(buildBreadcrumbs(site.navTree, site.navTree.pageIndex.at("x & y/one.html"))[0]["title"].get<std::string>(),
+               "x &amp; y", "escaped breadcrumb");
+  fs::remove_all(dir);
+}
+
+} // namespace
+
+int main() {
+  checkSite(SSG_SOURCE_DIR "/input", "input");
+
+  // Nested folders, single-page folders (collapsed, with a hidden sub folder) and names that need no escaping
+  const auto dir = fs::temp_directory_path() / "ssg_test_nav";
+  fs::remove_all(dir);
+  for (const char *file : {"index.md", "zeta.md", "a/one.md", "a/two.md", "a/b/deep.md", "a/b/deeper.md", "a/b/c/only.md",
+                           "single/page.md", "single/sub/x.md", "single/sub/y.md", "z/1.md", "z/2.md", "z/3.md", "readme.md", "a/readme.md"}) {
+    fs::create_directories((dir / file).parent_path());
+    std::ofstream(dir / file) << "# Page\n";
+  }
+  fs::create_directories(dir / "empty");
+  checkSite(dir, "tree");
+
+  // Hidden pages are known to the link rewriting but have no nav node
+  DirNode root = buildTree(dir, dir);
+  clearHeaders(root);
+  const NavTree tree = buildNavTree(root);
+  for (const char *hidden : {"single/sub/x.html", "single/sub/y.html"}) {
+    const auto node = tree.pageIndex.find(hidden);
+    check::that(node != tree.pageIndex.end() && node->second == 0, std::string("hidden page ") + hidden);
+  }
+  fs::remove_all(dir);
+
+  checkEscapedTitles(fs::temp_directory_path() / "ssg_test_nav_escaped");
+  return check::result();
+}
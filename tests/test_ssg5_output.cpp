@@ -0,0 +1,210 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Test of the ssg5 output, feed dates and write errors
+ */
+
+/**
+ * @file test_ssg5_output.cpp
+ * @brief Test of the ssg5 output, feed dates and write errors
+ *
+ * Sitemap and feed dates come from LAST_MODIFIED or CREATED only if they are
+ * ISO dates, otherwise from the file time. A page that cannot be written is
+ * reported as a write error (not a template error) and the other pages of
+ * the batch are still written. Directory output writes the same files with
+ * io_uring and with the thread pool. The log prints errors without waiting
+ * for the flush interval and messages logged after stop() directly.
+ */
+
+#define SSG5_NO_MAIN
+#include "../src/main5.cpp"
+
+#include <sstream>
+#include <thread>
+
+#include "check.hpp"
+
+namespace {
+
+/// Keeps the files in memory, writing "broken.html" fails
+class MemoryOutput : public SiteOutput {
+public:
+  std::mutex mutex;
+  std::map<std::string, std::string> files;
+
+  void write(const fs::path &path, std::string_view content) override {
+    if (path == "broken.html")
+      throw std::runtime_error("disk full");
+    std::lock_guard lock(mutex);
+    files[path.generic_string()] = std::string(content);
+  }
+};
+
+void testFeedDates() {
+  const auto dir = fs::temp_directory_path() / "ssg_test_output";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  const auto fileTime = fs::file_time_type::clock::now();
+  const std::string fileDate = formatFileTime(fileTime);
+
+  // Front matter of the pages, the expected date of each
+  const std::vector<std::tuple<json, std::string>> cases = {
+      {{{"CREATED", "2024-05-01"}}, "2024-05-01T00:00:00Z"},
+      {{{"CREATED", "2024-05-01T10:20:30Z"}}, "2024-05-01T10:20:30Z"},
+      {{{"LAST_MODIFIED", "2025-01-02"}, {"CREATED", "2024-05-01"}}, "2025-01-02T00:00:00Z"},
+      {{{"LAST_MODIFIED", "yesterday"}, {"CREATED", "2024-05-01"}}, "2024-05-01T00:00:00Z"},
+      {{{"CREATED", "May 2024"}}, fileDate},
+      {{{"CREATED", "2024-13-01"}}, fileDate},
+      {{{"CREATED", "2024-05-01 10:20"}}, fileDate},
+      {{{"CREATED", "2024-05-01T25:00:00Z"}}, fileDate},
+      {{{"CREATED", "2024-5-1"}}, fileDate},
+      {json::object(), fileDate},
+  };
+
+  std::vector<PageHeader> headers(cases.size());
+  std::vector<Page> pages(cases.size());
+  for (size_t i = 0; i < cases.size(); ++i) {
+    headers[i].meta = std::get<0>(cases[i]);
+    pages[i].inputPath = dir / std::format("page{}.md", i);
+    std::ofstream(pages[i].inputPath) << "# Page\n";
+    fs::last_write_time(pages[i].inputPath, fileTime);
+    pages[i].activePath = std::format("page{}.html", i);
+    pages[i].title = pages[i].activePath;
+    pages[i].header = &headers[i];
+  }
+
+  Config cfg;
+  cfg.siteUrl = "https://example.com";
+  cfg.feedSize = cases.size();
+  MemoryOutput output;
+  SiteFeeds feeds(cfg, output);
+  for (const auto &page : pages)
+    feeds.addPage(page);
+  feeds.finish();
+
+  const std::string &sitemap = output.files["sitemap.xml"];
+  const std::string &feed = output.files["feed.xml"];
+  for (size_t i = 0; i < cases.size(); ++i) {
+    const std::string &date = std::get<1>(cases[i]);
+    const std::string url = std::format("https://example.com/page{}.html", i);
+    check::that(sitemap.find(std::format("<loc>{}</loc><lastmod>{}</lastmod>", url, date.substr(0, 10))) != std::string::npos,
+                "sitemap date of " + headers[i].meta.dump());
+    check::that(feed.find(std::format("<link href=\"{}\"/>\n    <updated>{}</updated>", url, date)) != std::string::npos,
+                "feed date of " + headers[i].meta.dump());
+  }
+  fs::remove_all(dir);
+}
+
+void testWriteErrors() {
+  std::vector<Page> pages(3);
+  for (size_t i = 0; i < pages.size(); ++i) {
+    pages[i].activePath = std::array{"first.html", "broken.html", "last.html"}[i];
+    pages[i].title = pages[i].activePath;
+    pages[i].content = "<p>Content</p>";
+  }
+
+  inja::Environment env;
+  const inja::CompiledTemplate compiled = env.compile(env.parse("<h1>{{ title }}</h1>{{ content }}"));
+  inja::RenderContext ctx(compiled);
+  const Site site;
+  MemoryOutput output;
+
+  std::ostringstream errors;
+  auto *const stderrBuffer = std::cerr.rdbuf(errors.rdbuf());
+  size_t errorCount = 0;
+  {
+    Logger log(LogLevel::Error);
+    renderBatch(pages, site, compiled, ctx, false, output, Stages{}, nullptr, log);
+    errorCount = log.errors();
+  }
+  std::cerr.rdbuf(stderrBuffer);
+
+  check::that(errorCount == 1, "one error");
+  check::equal(errors.str(), "Error: Write error in broken.html: disk full\n", "reported as write error");
+  check::equal(output.files["first.html"], "<h1>first.html</h1><p>Content</p>", "page before the error");
+  check::equal(output.files["last.html"], "<h1>last.html</h1><p>Content</p>", "page after the error");
+}
+
+/// Collects stderr, readable while the log thread writes to it
+class LockedBuffer : public std::stringbuf {
+  std::recursive_mutex mutex; ///< xsputn calls overflow
+
+protected:
+  std::streamsize xsputn(const char *text, std::streamsize size) override {
+    std::lock_guard lock(mutex);
+    return std::stringbuf::xsputn(text, size);
+  }
+
+  int_type overflow(int_type ch) override {
+    std::lock_guard lock(mutex);
+    return std::stringbuf::overflow(ch);
+  }
+
+public:
+  std::string text() {
+    std::lock_guard lock(mutex);
+    return str();
+  }
+};
+
+void testLogger() {
+  LockedBuffer errors;
+  auto *const stderrBuffer = std::cerr.rdbuf(&errors);
+  {
+    Logger log(LogLevel::Error);
+    const auto start = std::chrono::steady_clock::now();
+    log.error("now");
+    while (errors.text().empty() && std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    check::that(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50), "error printed immediately");
+
+    // More messages than the ring holds, nothing reads the ring anymore
+    log.stop();
+    for (int i = 0; i < 3000; ++i)
+      log.error("late");
+  }
+  std::cerr.rdbuf(stderrBuffer);
+
+  const std::string text = errors.text();
+  check::that(text.starts_with("Error: now\n"), "first error");
+  size_t late = 0;
+  for (size_t pos = text.find("Error: late\n"); pos != std::string::npos; pos = text.find("Error: late\n", pos + 1))
+    ++late;
+  check::that(late == 3000, "errors after stop are printed");
+}
+
+/// Many small files and one empty file, written with io_uring (if supported) and with the thread pool
+void testDirectoryOutput() {
+  for (const bool ioUring : {true, false}) {
+    const auto dir = fs::temp_directory_path() / "ssg_test_directory_output";
+    std::vector<fs::path> folders;
+    for (size_t i = 0; i < 10; ++i)
+      folders.push_back(std::format("folder{}", i));
+    {
+      DirectoryOutput output(dir, ioUring);
+      output.createDirectories(folders);
+      for (size_t i = 0; i < 1000; ++i)
+        output.write(folders[i % 10] / std::format("page{}.html", i), std::string(i, 'x'));
+      output.finish();
+    }
+    size_t wrong = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+      if (readFile(dir / folders[i % 10] / std::format("page{}.html", i)) != std::string(i, 'x'))
+        ++wrong;
+    }
+    check::that(wrong == 0, ioUring ? "files written with io_uring" : "files written by the thread pool");
+    fs::remove_all(dir);
+  }
+}
+
+} // namespace
+
+int main() {
+  testFeedDates();
+  testWriteErrors();
+  testDirectoryOutput();
+  testLogger();
+  return check::result();
+}
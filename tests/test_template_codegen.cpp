@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * Author: Robert Zheng
+ * Copyright (c) 2026 ZHENG Robert
+ * Version: 1.0.0
+ * Description: Test of the template code generator's environment checks
+ */
+
+/**
+ * @file test_template_codegen.cpp
+ * @brief Test of the template code generator's environment checks
+ *
+ * Literals are printed at generation time and merged with the text around
+ * them. The generated code neither escapes HTML nor calls callbacks, so a
+ * template of an environment with HTML autoescape, or with a variable that a
+ * callback may answer, must be reported as unavailable.
+ */
+
+#define SSG_CODEGEN_NO_MAIN
+#include "../src/template_codegen.cpp"
+
+#include "check.hpp"
+
+namespace {
+
+std::string generate(inja::Environment &env, std::string_view input) {
+  return generateSource("test.html", env.compile(env.parse(input)));
+}
+
+bool available(const std::string &source) {
+  return source.find("extern const bool available = true;") != std::string::npos;
+}
+
+} // namespace
+
+int main() {
+  inja::Environment env;
+  const std::string source = generate(env, "<p>{{ \"a & b\" }} {{ 42 }}{{ null }} {{ true }}</p>{{ title }}");
+  check::that(available(source), "literals are supported");
+  check::that(source.find("json::parse") == std::string::npos, "literals are not parsed at render time");
+  check::that(source.find("\"<p>a & b 42 true</p>\"") != std::string::npos, "literals merged with the text");
+
+  inja::Environment escaping;
+  escaping.set_html_autoescape(true);
+  const std::string escaped = generate(escaping, "<p>{{ title }}</p>");
+  check::that(!available(escaped), "HTML autoescape is unsupported");
+  check::that(escaped.find("Unsupported: HTML autoescape") != std::string::npos, "reason of autoescape");
+
+  inja::Environment callbacks;
+  callbacks.add_callback("navigation", 0, [](inja::Arguments &) { return inja::json("<ul></ul>"); });
+  check::that(available(generate(callbacks, "{{ title }}")), "unrelated callback");
+  const std::string shadowed = generate(callbacks, "{% if navigation %}{{ title }}{% endif %}");
+  check::that(!available(shadowed), "variable shadowed by a callback is unsupported");
+  check::that(shadowed.find("Unsupported: variable 'navigation' shadowed by a callback") != std::string::npos,
+              "reason of the callback");
+  return check::result();
+}